@@ -12,6 +12,10 @@ Usage:
 If no files are specified, it will search for all performance_*.dat files
 in the current directory.
 
+The averages are taken from the cycle statistics file written next to each
+performance file (performance_metrics_cycles.dat for performance_metrics.dat)
+when it exists, so they do not depend on re-reading the full log.
+
 Author: IBAMR Implementation
 Date: 2025
 """
@@ -23,6 +27,12 @@ import sys
 import os
 from pathlib import Path
 
+def cycle_statistics_file(filename):
+    """Name of the cycle statistics file written next to a performance file"""
+    base = filename[:-4] if filename.endswith('.dat') else filename
+    return base + '_cycles.dat'
+
+
 class PerformanceAnalyzer:
     """Analyzes performance metrics from undulatory foil simulations"""
 
@@ -33,6 +43,7 @@ class PerformanceAnalyzer:
         self.reynolds_number = None
         self.thickness_ratio = None
         self.swimming_mode = None
+        self.cycles = None
         self.load_data()
 
     def load_data(self):
@@ -60,24 +71,60 @@ class PerformanceAnalyzer:
         self.power = self.data[:, 5]
         self.efficiency = self.data[:, 6]
 
+        # Per-cycle means and standard deviations, one row per completed tail-beat cycle
+        cycles_file = cycle_statistics_file(self.filename)
+        if os.path.exists(cycles_file):
+            cycles = np.loadtxt(cycles_file, comments='#', ndmin=2)
+            if len(cycles) > 0:
+                self.cycles = cycles
+
+    def compute_cycle_statistics(self):
+        """Compute statistics over the completed cycles after the initial transient"""
+        # Skip the first 20% of the cycles as transient
+        cycles = self.cycles[int(0.2 * len(self.cycles)):]
+        weights = cycles[:, 0] - cycles[:, 2]
+
+        def mean(col):
+            return np.average(cycles[:, col], weights=weights)
+
+        def std(mean_col, std_col):
+            # Pooled over the cycles: E[x^2] - E[x]^2
+            second_moment = np.average(cycles[:, std_col]**2 + cycles[:, mean_col]**2, weights=weights)
+            return np.sqrt(max(second_moment - mean(mean_col)**2, 0.0))
+
+        return {
+            'avg_speed': mean(3),
+            'avg_thrust': mean(5),
+            'avg_power': mean(7),
+            'avg_efficiency': mean(9),
+            'avg_amplitude': mean(11),
+            'avg_frequency': mean(12),
+            'std_speed': std(3, 4),
+            'std_efficiency': std(9, 10),
+        }
+
     def compute_statistics(self):
         """Compute time-averaged statistics after initial transient"""
-        # Skip first 20% as transient
-        start_idx = int(0.2 * len(self.time))
-
         stats = {
             'Re': self.reynolds_number,
             'h/L': self.thickness_ratio,
             'mode': self.swimming_mode,
-            'avg_speed': np.mean(self.swimming_speed[start_idx:]),
-            'avg_thrust': np.mean(self.thrust[start_idx:]),
-            'avg_power': np.mean(self.power[start_idx:]),
-            'avg_efficiency': np.mean(self.efficiency[start_idx:]),
-            'avg_amplitude': np.mean(self.adapted_amplitude[start_idx:]),
-            'avg_frequency': np.mean(self.adapted_frequency[start_idx:]),
-            'std_speed': np.std(self.swimming_speed[start_idx:]),
-            'std_efficiency': np.std(self.efficiency[start_idx:]),
         }
+        if self.cycles is not None:
+            stats.update(self.compute_cycle_statistics())
+        else:
+            # Skip first 20% as transient
+            start_idx = int(0.2 * len(self.time))
+            stats.update({
+                'avg_speed': np.mean(self.swimming_speed[start_idx:]),
+                'avg_thrust': np.mean(self.thrust[start_idx:]),
+                'avg_power': np.mean(self.power[start_idx:]),
+                'avg_efficiency': np.mean(self.efficiency[start_idx:]),
+                'avg_amplitude': np.mean(self.adapted_amplitude[start_idx:]),
+                'avg_frequency': np.mean(self.adapted_frequency[start_idx:]),
+                'std_speed': np.std(self.swimming_speed[start_idx:]),
+                'std_efficiency': np.std(self.efficiency[start_idx:]),
+            })
 
         # Compute Strouhal number: St = f * A / U
         if stats['avg_speed'] > 0:
@@ -229,7 +276,7 @@ def main():
     if len(sys.argv) > 1:
         files = sys.argv[1:]
     else:
-        files = glob.glob('performance*.dat')
+        files = [f for f in glob.glob('performance*.dat') if not f.endswith('_cycles.dat')]
 
     if not files:
         print("No performance data files found!")
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""
+Check of the Sampled Control-Volume Forces
+==========================================
+
+Compares the drag or torque file of a run with force_sample_interval = K > 1
+with that of the same run with force_sample_interval = 1. On each time that
+both files have, the sampled force must match the force of the unsampled run,
+i.e. the structure inertia of a sample is that of its own step and not the
+momentum change since the previous sample.
+
+The control volume of a sampled run moves at most one coarse mesh width per
+sample, so compare a stretch of the run in which the box of the sampled run
+has caught up with that of the reference run (e.g. a fixed box, or a body
+that moves less than one mesh width between samples).
+
+Usage:
+    python compare_force_samples.py reference_file sampled_file [--tolerance 1e-8]
+
+The files have one row per sample: the time, then the components. Exits with
+status 1 if a component differs by more than the tolerance, relative to the
+largest magnitude of that component in the reference file.
+"""
+
+import argparse
+import sys
+
+
+def read_rows(filename):
+    """Rows of a force file as lists of floats, skipping blank and comment lines"""
+    rows = []
+    with open(filename) as f:
+        for line in f:
+            fields = line.split()
+            if not fields or fields[0].startswith('#'):
+                continue
+            rows.append([float(x) for x in fields])
+    return rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare sampled control-volume forces with unsampled ones')
+    parser.add_argument('reference', help='force file of the run with force_sample_interval = 1')
+    parser.add_argument('sampled', help='force file of the run with force_sample_interval > 1')
+    parser.add_argument('--tolerance', type=float, default=1.0e-8, help='relative tolerance (default 1e-8)')
+    args = parser.parse_args()
+
+    reference = read_rows(args.reference)
+    sampled = read_rows(args.sampled)
+    if not reference or not sampled:
+        print('No samples to compare')
+        sys.exit(1)
+
+    num_components = len(reference[0]) - 1
+    scale = [max(abs(row[k + 1]) for row in reference) or 1.0 for k in range(num_components)]
+    reference_by_time = {'%.10e' % row[0]: row for row in reference}
+
+    num_compared, max_error = 0, 0.0
+    for row in sampled:
+        ref = reference_by_time.get('%.10e' % row[0])
+        if ref is None:
+            continue
+        num_compared += 1
+        for k in range(num_components):
+            error = abs(row[k + 1] - ref[k + 1]) / scale[k]
+            if error > max_error:
+                max_error = error
+            if error > args.tolerance:
+                print('time %.10e component %d: sampled %.10e, reference %.10e' % (row[0], k, row[k + 1], ref[k + 1]))
+
+    if num_compared == 0:
+        print('The files have no time in common')
+        sys.exit(1)
+    print('%d samples compared, largest relative difference %.3e' % (num_compared, max_error))
+    sys.exit(0 if max_error <= args.tolerance else 1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""
+Reader for the Shared Hierarchy Data Dumps
+==========================================
+
+Reads the hier_data.NNNNN.bin files written by HierarchyDataWriter when the
+input file sets hierarchy_dump_format = "SHARED". Only the header and the
+patch index are read up front; the values of a patch are read when it is
+requested, so a sub-region of a large dump is loaded without reading the
+rest of the file.
+
+Usage:
+    python read_hierarchy_data.py hier_data.00100.bin
+    python read_hierarchy_data.py hier_data.00100.bin --variable P --level 2 \\
+        --region -0.5 -0.5 1.5 0.5 --npz wake.npz
+
+Without --variable, prints the variables and patches of the file.
+"""
+
+import argparse
+import struct
+import sys
+
+import numpy as np
+
+MAGIC = b'EEL2DHIE'
+HEADER_SIZE = 64
+NAME_SIZE = 64
+CENTERINGS = {0: 'cell', 1: 'side'}
+
+
+class HierarchyDump:
+    """Header, variables and patch index of a shared hierarchy dump"""
+
+    def __init__(self, filename):
+        self.filename = filename
+        with open(filename, 'rb') as f:
+            raw = f.read(HEADER_SIZE)
+            if len(raw) != HEADER_SIZE or raw[:8] != MAGIC:
+                raise ValueError('not a shared hierarchy dump: %s' % filename)
+            (self.version, self.dim, self.time_step, num_variables, num_records,
+             self.time, index_offset, data_offset) = struct.unpack('=4iqdqq', raw[8:56])
+
+            self.variables = []
+            for _ in range(num_variables):
+                entry = f.read(NAME_SIZE + 8)
+                name = entry[:NAME_SIZE].split(b'\0', 1)[0].decode()
+                centering, depth = struct.unpack('=2i', entry[NAME_SIZE:])
+                self.variables.append({'name': name, 'centering': CENTERINGS[centering], 'depth': depth})
+
+            dim = self.dim
+            record_format = '=4i%di%dd2q' % (2 * dim, 2 * dim)
+            record_size = struct.calcsize(record_format)
+            f.seek(index_offset)
+            index = f.read(record_size * num_records)
+            self.patches = []
+            for k in range(num_records):
+                fields = struct.unpack_from(record_format, index, k * record_size)
+                self.patches.append({
+                    'level': fields[0],
+                    'variable': fields[1],
+                    'rank': fields[2],
+                    'lower': fields[4:4 + dim],
+                    'upper': fields[4 + dim:4 + 2 * dim],
+                    'x_lower': np.array(fields[4 + 2 * dim:4 + 3 * dim]),
+                    'dx': np.array(fields[4 + 3 * dim:4 + 4 * dim]),
+                    'offset': fields[4 + 4 * dim],
+                    'num_values': fields[5 + 4 * dim],
+                })
+
+    def variable_number(self, name):
+        for k, var in enumerate(self.variables):
+            if var['name'] == name:
+                return k
+        raise KeyError('no variable %s in %s' % (name, self.filename))
+
+    def read_patch(self, patch):
+        """Values of a patch: one array per axis for side data, a single array for cell data.
+
+        The arrays have shape (depth, n_(dim-1), ..., n_0), the first index varying fastest."""
+        var = self.variables[patch['variable']]
+        with open(self.filename, 'rb') as f:
+            f.seek(patch['offset'])
+            values = np.fromfile(f, dtype=np.float64, count=patch['num_values'])
+        cells = [u - l + 1 for l, u in zip(patch['lower'], patch['upper'])]
+        if var['centering'] == 'cell':
+            return values.reshape([var['depth']] + cells[::-1])
+        arrays, start = [], 0
+        for axis in range(self.dim):
+            sides = [n + 1 if d == axis else n for d, n in enumerate(cells)]
+            count = var['depth'] * int(np.prod(sides))
+            arrays.append(values[start:start + count].reshape([var['depth']] + sides[::-1]))
+            start += count
+        return arrays
+
+    def patches_in_region(self, name, level, x_lower, x_upper):
+        """Patches of a variable on a level that overlap the box [x_lower, x_upper]"""
+        var = self.variable_number(name)
+        found = []
+        for patch in self.patches:
+            if patch['variable'] != var or patch['level'] != level:
+                continue
+            cells = np.array([u - l + 1 for l, u in zip(patch['lower'], patch['upper'])])
+            patch_x_upper = patch['x_lower'] + cells * patch['dx']
+            if np.all(patch['x_lower'] < x_upper) and np.all(patch_x_upper > x_lower):
+                found.append(patch)
+        return found
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Read shared hierarchy data dumps')
+    parser.add_argument('file', help='hier_data.NNNNN.bin file')
+    parser.add_argument('--variable', help='variable to read (e.g. U or P)')
+    parser.add_argument('--level', type=int, default=0, help='patch level number')
+    parser.add_argument('--region', type=float, nargs='+',
+                        help='lower corner followed by upper corner of the region (default: all)')
+    parser.add_argument('--npz', help='save the patches read to this .npz file')
+    args = parser.parse_args()
+
+    dump = HierarchyDump(args.file)
+    print('time step %d, time %.6e, %d patch records'
+          % (dump.time_step, dump.time, len(dump.patches)))
+    for var in dump.variables:
+        print('  %s: %s centered, depth %d' % (var['name'], var['centering'], var['depth']))
+
+    if not args.variable:
+        levels = sorted(set(p['level'] for p in dump.patches))
+        for ln in levels:
+            count = sum(1 for p in dump.patches if p['level'] == ln and p['variable'] == 0)
+            print('  level %d: %d patches' % (ln, count))
+        return
+
+    if args.region:
+        if len(args.region) != 2 * dump.dim:
+            print('--region needs %d values' % (2 * dump.dim))
+            sys.exit(1)
+        x_lower = np.array(args.region[:dump.dim])
+        x_upper = np.array(args.region[dump.dim:])
+    else:
+        x_lower = np.full(dump.dim, -np.inf)
+        x_upper = np.full(dump.dim, np.inf)
+
+    patches = dump.patches_in_region(args.variable, args.level, x_lower, x_upper)
+    print('%d patches of %s on level %d overlap the region' % (len(patches), args.variable, args.level))
+    arrays = {}
+    for k, patch in enumerate(patches):
+        data = dump.read_patch(patch)
+        if isinstance(data, list):
+            for axis, values in enumerate(data):
+                arrays['patch%d_axis%d' % (k, axis)] = values
+        else:
+            arrays['patch%d' % k] = data
+        arrays['patch%d_x_lower' % k] = patch['x_lower']
+        arrays['patch%d_dx' % k] = patch['dx']
+
+    if args.npz:
+        np.savez(args.npz, **arrays)
+        print('Saved %d patches to %s' % (len(patches), args.npz))
+
+
+if __name__ == '__main__':
+    main()
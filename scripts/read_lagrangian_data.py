@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+Reader for the Binary Lagrangian Position Dumps
+===============================================
+
+Reads the X.NNNNN.bin files written by LagrangianDataWriter when the input
+file sets lagrangian_dump_format = "BINARY". Files holding deltas are
+reconstructed from the dump of their reference time step, so a series has to
+be read from a keyframe on.
+
+Usage:
+    python read_lagrangian_data.py [--npz output.npz] X.00000.bin X.00010.bin ...
+
+If no files are specified, all X.*.bin files in the current directory are
+read in the order of their time step numbers.
+"""
+
+import argparse
+import glob
+import struct
+import sys
+
+import numpy as np
+
+MAGIC = b'EEL2DLAG'
+HEADER_SIZE = 48
+
+
+def read_header(f):
+    """Read the header of a dump from an open binary file"""
+    raw = f.read(HEADER_SIZE)
+    if len(raw) != HEADER_SIZE or raw[:8] != MAGIC:
+        raise ValueError('not a Lagrangian position dump: %s' % f.name)
+    (version, dim, time_step, value_size, is_delta, reference_step,
+     num_points, time) = struct.unpack('=6iqd', raw[8:])
+    return {
+        'version': version,
+        'dim': dim,
+        'time_step': time_step,
+        'value_size': value_size,
+        'is_delta': bool(is_delta),
+        'reference_step': reference_step,
+        'num_points': num_points,
+        'time': time,
+    }
+
+
+def read_dump(filename):
+    """Return the header and the values of one dump, as stored (positions or deltas)"""
+    with open(filename, 'rb') as f:
+        header = read_header(f)
+        dtype = np.float32 if header['value_size'] == 4 else np.float64
+        count = header['num_points'] * header['dim']
+        values = np.fromfile(f, dtype=dtype, count=count)
+    if values.size != count:
+        raise ValueError('%s is truncated' % filename)
+    return header, values.reshape(header['num_points'], header['dim'])
+
+
+def read_positions(filenames):
+    """Yield (header, positions) for a series of dumps, adding deltas to their reference dumps"""
+    previous_step, previous_X = None, None
+    for filename in filenames:
+        header, values = read_dump(filename)
+        if header['is_delta']:
+            if previous_step != header['reference_step']:
+                raise ValueError('%s holds deltas to time step %d, which was not read just before it'
+                                 % (filename, header['reference_step']))
+            # Same double precision sum as the writer, so the positions match its reference exactly.
+            X = previous_X + values.astype(np.float64)
+        else:
+            X = values.astype(np.float64)
+        previous_step, previous_X = header['time_step'], X
+        yield header, X
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Read binary Lagrangian position dumps')
+    parser.add_argument('files', nargs='*', help='X.NNNNN.bin files, in time step order')
+    parser.add_argument('--npz', help='save the times and positions to this .npz file')
+    args = parser.parse_args()
+
+    files = args.files
+    if not files:
+        files = sorted(glob.glob('X.*.bin'))
+    if not files:
+        print('No X.*.bin files found')
+        sys.exit(1)
+
+    times, positions = [], []
+    for header, X in read_positions(files):
+        kind = 'delta' if header['is_delta'] else 'keyframe'
+        print('step %6d  time %12.6e  %d points  %s  x in [%g, %g]  y in [%g, %g]'
+              % (header['time_step'], header['time'], header['num_points'], kind,
+                 X[:, 0].min(), X[:, 0].max(), X[:, 1].min(), X[:, 1].max()))
+        times.append(header['time'])
+        positions.append(X)
+
+    if args.npz:
+        np.savez(args.npz, time=np.array(times), X=np.array(positions))
+        print('Saved %d dumps to %s' % (len(times), args.npz))
+
+
+if __name__ == '__main__':
+    main()
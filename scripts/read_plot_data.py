@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+"""
+Reader for the Asynchronous Visualization Dumps
+===============================================
+
+Reads the plot.NNNNN.RRRRR.bin files written by AsyncPlotDataWriter when the
+input file sets async_viz_output = TRUE, one file per rank and time step, and
+converts them to VTK files that ParaView and VisIt open. Each dump becomes a
+multiblock file plot.NNNNN.vtm with one image data block (.vti) per patch,
+grouped by level, and a point cloud (.vtp) of the Lagrangian points. Side
+centered data are averaged to the cell centers, and a side centered variable
+of depth 1 (e.g. the velocity) becomes a cell centered vector.
+
+Usage:
+    python read_plot_data.py [--vtk output_dir] [--npz output.npz] viz_dir/plot.00100.summary ...
+
+If no summary files are specified, all plot.*.summary files in the current
+directory are read. Without --vtk or --npz, prints the contents of the dumps.
+"""
+
+import argparse
+import glob
+import os
+import struct
+import sys
+
+import numpy as np
+
+MAGIC = b'EEL2DPLT'
+CENTERINGS = {0: 'cell', 1: 'side'}
+
+
+class Reader:
+    """Sequential reader of the fields of a rank file"""
+
+    def __init__(self, data, filename):
+        self.data, self.pos, self.filename = data, 0, filename
+
+    def unpack(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise ValueError('%s is truncated' % self.filename)
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return values
+
+    def array(self, dtype, count):
+        values = np.frombuffer(self.data, dtype=dtype, count=count, offset=self.pos)
+        self.pos += values.nbytes
+        return values
+
+
+def read_rank_file(filename):
+    """Header, variables, patches and Lagrangian points of the file of one rank"""
+    with open(filename, 'rb') as f:
+        reader = Reader(f.read(), filename)
+    if reader.data[:8] != MAGIC:
+        raise ValueError('not an asynchronous visualization dump: %s' % filename)
+    reader.pos = 8
+    version, dim, time_step, rank, num_ranks = reader.unpack('=5i')
+    (time,) = reader.unpack('=d')
+    dump = {'version': version, 'dim': dim, 'time_step': time_step, 'rank': rank, 'num_ranks': num_ranks,
+            'time': time, 'variables': [], 'patches': []}
+
+    (num_variables,) = reader.unpack('=i')
+    for _ in range(num_variables):
+        (length,) = reader.unpack('=i')
+        name = reader.data[reader.pos:reader.pos + length].decode()
+        reader.pos += length
+        centering, depth = reader.unpack('=2i')
+        dump['variables'].append({'name': name, 'centering': CENTERINGS[centering], 'depth': depth})
+
+    (num_patches,) = reader.unpack('=i')
+    for _ in range(num_patches):
+        level, variable = reader.unpack('=2i')
+        lower = reader.unpack('=%di' % dim)
+        upper = reader.unpack('=%di' % dim)
+        x_lower = np.array(reader.unpack('=%dd' % dim))
+        dx = np.array(reader.unpack('=%dd' % dim))
+        (num_values,) = reader.unpack('=q')
+        values = reader.array(np.float64, num_values)
+        dump['patches'].append({'level': level, 'variable': variable, 'lower': lower, 'upper': upper,
+                                'x_lower': x_lower, 'dx': dx, 'values': values})
+
+    (num_points,) = reader.unpack('=i')
+    record = np.dtype([('index', np.int32), ('X', np.float64, (dim,))])
+    points = reader.array(record, num_points)
+    dump['lag_index'] = points['index'].astype(np.int64)
+    dump['X'] = points['X'].reshape(num_points, dim).astype(np.float64)
+    return dump
+
+
+def read_dump(summary_file):
+    """Merge the files of all ranks of the dump described by a plot.NNNNN.summary file"""
+    summary = {}
+    with open(summary_file) as f:
+        for line in f:
+            if line.strip():
+                key, value = line.split()
+                summary[key] = value
+    time_step, num_ranks = int(summary['time_step_number']), int(summary['num_ranks'])
+    dirname = os.path.dirname(summary_file)
+    dump = None
+    for rank in range(num_ranks):
+        part = read_rank_file(os.path.join(dirname, 'plot.%05d.%05d.bin' % (time_step, rank)))
+        if dump is None:
+            dump = part
+            continue
+        dump['patches'].extend(part['patches'])
+        dump['lag_index'] = np.concatenate([dump['lag_index'], part['lag_index']])
+        dump['X'] = np.concatenate([dump['X'], part['X']])
+    order = np.argsort(dump['lag_index'])
+    dump['lag_index'], dump['X'] = dump['lag_index'][order], dump['X'][order]
+    return dump
+
+
+def patch_cell_values(dump, patch):
+    """Cell centered values of a patch, shape (components, n_(dim-1), ..., n_0)"""
+    var = dump['variables'][patch['variable']]
+    dim = dump['dim']
+    cells = [u - l + 1 for l, u in zip(patch['lower'], patch['upper'])]
+    values = patch['values']
+    if var['centering'] == 'cell':
+        return values.reshape([var['depth']] + cells[::-1])
+    averages, start = [], 0
+    for axis in range(dim):
+        sides = [n + 1 if d == axis else n for d, n in enumerate(cells)]
+        count = var['depth'] * int(np.prod(sides))
+        side_values = values[start:start + count].reshape([var['depth']] + sides[::-1])
+        start += count
+        # The arrays are indexed (component, ..., i_1, i_0), so the axis is array dimension dim - axis.
+        n = side_values.shape[dim - axis]
+        lower = np.take(side_values, range(0, n - 1), axis=dim - axis)
+        upper = np.take(side_values, range(1, n), axis=dim - axis)
+        averages.append(0.5 * (lower + upper))
+    # The components are ordered by axis, then by depth; depth 1 gives one component per axis.
+    return np.concatenate(averages, axis=0)
+
+
+def write_vtk(dump, output_dir):
+    """Write the dump as plot.NNNNN.vtm with .vti patch blocks and a .vtp point cloud"""
+    dim = dump['dim']
+    base = 'plot.%05d' % dump['time_step']
+    block_dir = os.path.join(output_dir, base)
+    os.makedirs(block_dir, exist_ok=True)
+
+    # Gather the variables of each patch box.
+    boxes = {}
+    for patch in dump['patches']:
+        key = (patch['level'], tuple(patch['lower']), tuple(patch['upper']))
+        boxes.setdefault(key, []).append(patch)
+
+    blocks = {}
+    for k, (key, patches) in enumerate(sorted(boxes.items())):
+        level = key[0]
+        cells = [u - l + 1 for l, u in zip(patches[0]['lower'], patches[0]['upper'])]
+        extent = ' '.join('0 %d' % (cells[d] if d < dim else 0) for d in range(3))
+        origin = ' '.join('%.16g' % (patches[0]['x_lower'][d] if d < dim else 0.0) for d in range(3))
+        spacing = ' '.join('%.16g' % (patches[0]['dx'][d] if d < dim else 1.0) for d in range(3))
+        file_name = 'level%d_patch%05d.vti' % (level, k)
+        with open(os.path.join(block_dir, file_name), 'w') as f:
+            f.write('<?xml version="1.0"?>\n')
+            f.write('<VTKFile type="ImageData" version="0.1" byte_order="LittleEndian">\n')
+            f.write('<ImageData WholeExtent="%s" Origin="%s" Spacing="%s">\n' % (extent, origin, spacing))
+            f.write('<Piece Extent="%s">\n<CellData>\n' % extent)
+            for patch in patches:
+                var = dump['variables'][patch['variable']]
+                values = patch_cell_values(dump, patch)
+                components = values.shape[0]
+                if var['centering'] == 'side' and var['depth'] == 1 and dim < 3:
+                    values = np.concatenate([values, np.zeros((3 - dim,) + values.shape[1:])], axis=0)
+                    components = 3
+                flat = values.reshape(values.shape[0], -1).T
+                f.write('<DataArray type="Float64" Name="%s" NumberOfComponents="%d" format="ascii">\n'
+                        % (var['name'], components))
+                np.savetxt(f, flat, fmt='%.9e')
+                f.write('</DataArray>\n')
+            f.write('</CellData>\n</Piece>\n</ImageData>\n</VTKFile>\n')
+        blocks.setdefault(level, []).append(os.path.join(base, file_name))
+
+    points_name = os.path.join(base, 'lagrangian_points.vtp')
+    num_points = dump['X'].shape[0]
+    X = np.zeros((num_points, 3))
+    X[:, :dim] = dump['X']
+    with open(os.path.join(output_dir, points_name), 'w') as f:
+        f.write('<?xml version="1.0"?>\n')
+        f.write('<VTKFile type="PolyData" version="0.1" byte_order="LittleEndian">\n<PolyData>\n')
+        f.write('<Piece NumberOfPoints="%d" NumberOfVerts="%d">\n' % (num_points, num_points))
+        f.write('<PointData>\n<DataArray type="Int64" Name="lag_index" format="ascii">\n')
+        np.savetxt(f, dump['lag_index'], fmt='%d')
+        f.write('</DataArray>\n</PointData>\n<Points>\n')
+        f.write('<DataArray type="Float64" NumberOfComponents="3" format="ascii">\n')
+        np.savetxt(f, X, fmt='%.16e')
+        f.write('</DataArray>\n</Points>\n<Verts>\n<DataArray type="Int64" Name="connectivity" format="ascii">\n')
+        np.savetxt(f, np.arange(num_points), fmt='%d')
+        f.write('</DataArray>\n<DataArray type="Int64" Name="offsets" format="ascii">\n')
+        np.savetxt(f, np.arange(1, num_points + 1), fmt='%d')
+        f.write('</DataArray>\n</Verts>\n</Piece>\n</PolyData>\n</VTKFile>\n')
+
+    vtm_name = os.path.join(output_dir, base + '.vtm')
+    with open(vtm_name, 'w') as f:
+        f.write('<?xml version="1.0"?>\n')
+        f.write('<VTKFile type="vtkMultiBlockDataSet" version="1.0" byte_order="LittleEndian">\n')
+        f.write('<vtkMultiBlockDataSet>\n')
+        for n, level in enumerate(sorted(blocks)):
+            f.write('<Block index="%d" name="level%d">\n' % (n, level))
+            for m, file_name in enumerate(blocks[level]):
+                f.write('<DataSet index="%d" file="%s"/>\n' % (m, file_name))
+            f.write('</Block>\n')
+        f.write('<DataSet index="%d" name="lagrangian_points" file="%s"/>\n' % (len(blocks), points_name))
+        f.write('</vtkMultiBlockDataSet>\n</VTKFile>\n')
+    return vtm_name
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Read asynchronous visualization dumps')
+    parser.add_argument('files', nargs='*', help='plot.NNNNN.summary files')
+    parser.add_argument('--vtk', help='write VTK files for ParaView or VisIt to this directory')
+    parser.add_argument('--npz', help='save the times and Lagrangian positions to this .npz file')
+    args = parser.parse_args()
+
+    files = args.files
+    if not files:
+        files = sorted(glob.glob('plot.*.summary'))
+    if not files:
+        print('No plot.*.summary files found')
+        sys.exit(1)
+
+    times, positions = [], []
+    for summary_file in files:
+        dump = read_dump(summary_file)
+        levels = sorted(set(p['level'] for p in dump['patches']))
+        print('step %6d  time %12.6e  %d ranks  %d patch records on levels %s  %d points'
+              % (dump['time_step'], dump['time'], dump['num_ranks'], len(dump['patches']),
+                 levels, dump['X'].shape[0]))
+        for var in dump['variables']:
+            print('  %s: %s centered, depth %d' % (var['name'], var['centering'], var['depth']))
+        if args.vtk:
+            print('  wrote %s' % write_vtk(dump, args.vtk))
+        times.append(dump['time'])
+        positions.append(dump['X'])
+
+    if args.npz:
+        np.savez(args.npz, time=np.array(times), X=np.array(positions))
+        print('Saved %d dumps to %s' % (len(times), args.npz))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,149 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+//////////////////////////// INCLUDES /////////////////////////////////////////
+
+#include "AllocationCounter.h"
+
+#ifdef EEL2D_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#endif
+
+/////////////////////////////// NAMESPACE ////////////////////////////////////
+
+#ifdef EEL2D_COUNT_ALLOCATIONS
+namespace
+{
+// Shared by all threads, so that the allocations of the workers of a parallel section are counted as well.
+// Threads that run alongside the time stepping, such as the background writers, opt out.
+std::atomic<unsigned long long> num_allocations(0);
+thread_local bool thread_is_ignored = false;
+
+void*
+counted_allocate(std::size_t size)
+{
+    if (!thread_is_ignored) num_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    while (true)
+    {
+        void* ptr = std::malloc(size);
+        if (ptr) return ptr;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+} // counted_allocate
+
+} // namespace
+
+void*
+operator new(std::size_t size)
+{
+    return counted_allocate(size);
+}
+
+void*
+operator new[](std::size_t size)
+{
+    return counted_allocate(size);
+}
+
+void*
+operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return counted_allocate(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void*
+operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return counted_allocate(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif // EEL2D_COUNT_ALLOCATIONS
+
+namespace IBAMR
+{
+namespace AllocationCounter
+{
+bool
+isEnabled()
+{
+#ifdef EEL2D_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+} // isEnabled
+
+unsigned long long
+getCount()
+{
+#ifdef EEL2D_COUNT_ALLOCATIONS
+    return num_allocations.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+} // getCount
+
+void
+ignoreCallingThread()
+{
+#ifdef EEL2D_COUNT_ALLOCATIONS
+    thread_is_ignored = true;
+#endif
+    return;
+} // ignoreCallingThread
+
+} // namespace AllocationCounter
+
+} // namespace IBAMR
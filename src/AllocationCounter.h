@@ -0,0 +1,49 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_AllocationCounter
+#define included_AllocationCounter
+
+namespace IBAMR
+{
+/*!
+ * \brief Namespace AllocationCounter exposes a count of the heap allocations made by all threads, including
+ * the workers of OpenMP parallel sections, except those that called ignoreCallingThread().
+ *
+ * The count is maintained by replacements of the global operator new that are compiled in only when
+ * the code is configured with EEL2D_COUNT_ALLOCATIONS=ON (compile definition EEL2D_COUNT_ALLOCATIONS).
+ * Otherwise isEnabled() returns false and getCount() always returns zero.
+ */
+namespace AllocationCounter
+{
+/*!
+ * \brief Whether heap allocations are being counted in this build.
+ */
+bool isEnabled();
+
+/*!
+ * \brief Number of heap allocations made so far by the threads that are counted.
+ */
+unsigned long long getCount();
+
+/*!
+ * \brief Stop counting the allocations of the calling thread, e.g. a background writer whose allocations do not
+ * belong to the time step that happens to be running.
+ */
+void ignoreCallingThread();
+
+} // namespace AllocationCounter
+
+} // namespace IBAMR
+
+#endif // #ifndef included_AllocationCounter
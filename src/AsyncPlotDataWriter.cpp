@@ -0,0 +1,204 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+//////////////////////////// INCLUDES /////////////////////////////////////////
+#include "ibtk/IBTK_MPI.h"
+#include "ibtk/LData.h"
+#include "ibtk/LMesh.h"
+#include "ibtk/LNode.h"
+
+#include "AllocationCounter.h"
+#include "AsyncPlotDataWriter.h"
+#include "tbox/Utilities.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <string>
+
+#include "ibamr/namespaces.h"
+
+namespace IBAMR
+{
+namespace
+{
+static const char FILE_MAGIC[8] = { 'E', 'E', 'L', '2', 'D', 'P', 'L', 'T' };
+static const int FILE_VERSION = 1;
+
+template <class T>
+inline void
+write_binary(std::ofstream& stream, const T* values, const std::size_t n)
+{
+    stream.write(reinterpret_cast<const char*>(values), n * sizeof(T));
+    return;
+} // write_binary
+
+template <class T>
+inline void
+write_binary(std::ofstream& stream, const T value)
+{
+    write_binary(stream, &value, 1);
+    return;
+} // write_binary
+
+} // namespace
+
+AsyncPlotDataWriter::AsyncPlotDataWriter(const std::string& object_name, const std::string& dirname)
+    : d_object_name(object_name),
+      d_dirname(dirname),
+      d_rank(IBTK_MPI::getRank()),
+      d_num_ranks(IBTK_MPI::getNodes()),
+      d_time_step_number(0),
+      d_simulation_time(0.0),
+      d_snapshot(object_name + "::PatchDataSnapshot")
+{
+    Utilities::recursiveMkdir(d_dirname);
+    IBTK_MPI::barrier();
+    return;
+} // AsyncPlotDataWriter
+
+AsyncPlotDataWriter::~AsyncPlotDataWriter()
+{
+    if (d_thread.joinable()) d_thread.join();
+    return;
+} // ~AsyncPlotDataWriter
+
+void
+AsyncPlotDataWriter::registerPlotData(const std::string& name, const int patch_data_idx)
+{
+    d_snapshot.registerPatchData(name, patch_data_idx);
+    return;
+} // registerPlotData
+
+void
+AsyncPlotDataWriter::writePlotData(Pointer<PatchHierarchy<NDIM> > hierarchy,
+                                   LDataManager* l_data_manager,
+                                   const int time_step_number,
+                                   const double simulation_time)
+{
+    // The buffers are reused, so the previous dump has to be on disk first.
+    waitForCompletion();
+    d_time_step_number = time_step_number;
+    d_simulation_time = simulation_time;
+
+    // Copy the interior values of the registered patch data.
+    d_snapshot.copyPatchData(hierarchy);
+
+    // Copy the positions of the local Lagrangian points.
+    d_lag_indices.clear();
+    d_X.clear();
+    const int finest_ln = hierarchy->getFinestLevelNumber();
+    if (l_data_manager && l_data_manager->levelContainsLagrangianData(finest_ln))
+    {
+        Pointer<LData> X_data = l_data_manager->getLData("X", finest_ln);
+        const boost::multi_array_ref<double, 2>& X = *X_data->getLocalFormVecArray();
+        const std::vector<LNode*>& local_nodes = l_data_manager->getLMesh(finest_ln)->getLocalNodes();
+        for (std::vector<LNode*>::const_iterator it = local_nodes.begin(); it != local_nodes.end(); ++it)
+        {
+            const int local_idx = (*it)->getLocalPETScIndex();
+            d_lag_indices.push_back((*it)->getLagrangianIndex());
+            for (int d = 0; d < NDIM; ++d) d_X.push_back(X[local_idx][d]);
+        }
+        X_data->restoreArrays();
+    }
+
+    d_thread = std::thread(&AsyncPlotDataWriter::writeFiles, this);
+    return;
+} // writePlotData
+
+void
+AsyncPlotDataWriter::waitForCompletion()
+{
+    if (!d_thread.joinable()) return;
+    d_thread.join();
+    if (!d_error_message.empty())
+    {
+        TBOX_ERROR(d_object_name << "::waitForCompletion() :\n"
+                                 << "  " << d_error_message << std::endl);
+    }
+    return;
+} // waitForCompletion
+
+void
+AsyncPlotDataWriter::writeFiles()
+{
+    AllocationCounter::ignoreCallingThread();
+    d_error_message.clear();
+    char temp_buf[128];
+    std::sprintf(temp_buf, "/plot.%05d.%05d.bin", d_time_step_number, d_rank);
+    const std::string file_name = d_dirname + temp_buf;
+    std::ofstream stream(file_name.c_str(), std::ios::out | std::ios::binary);
+
+    write_binary(stream, FILE_MAGIC, sizeof(FILE_MAGIC));
+    write_binary<int>(stream, FILE_VERSION);
+    write_binary<int>(stream, NDIM);
+    write_binary<int>(stream, d_time_step_number);
+    write_binary<int>(stream, d_rank);
+    write_binary<int>(stream, d_num_ranks);
+    write_binary<double>(stream, d_simulation_time);
+
+    const std::vector<PatchDataSnapshot::Variable>& variables = d_snapshot.getVariables();
+    write_binary<int>(stream, static_cast<int>(variables.size()));
+    for (std::vector<PatchDataSnapshot::Variable>::const_iterator it = variables.begin(); it != variables.end();
+         ++it)
+    {
+        write_binary<int>(stream, static_cast<int>(it->name.size()));
+        write_binary(stream, it->name.data(), it->name.size());
+        write_binary<int>(stream, it->centering);
+        write_binary<int>(stream, it->depth);
+    }
+
+    const std::vector<PatchDataSnapshot::PatchRecord>& patches = d_snapshot.getPatches();
+    const std::vector<double>& values = d_snapshot.getValues();
+    write_binary<int>(stream, static_cast<int>(patches.size()));
+    for (std::vector<PatchDataSnapshot::PatchRecord>::const_iterator it = patches.begin(); it != patches.end();
+         ++it)
+    {
+        write_binary<int>(stream, it->level_number);
+        write_binary<int>(stream, it->variable);
+        write_binary(stream, it->lower, NDIM);
+        write_binary(stream, it->upper, NDIM);
+        write_binary(stream, it->x_lower, NDIM);
+        write_binary(stream, it->dx, NDIM);
+        write_binary<long long>(stream, static_cast<long long>(it->num_values));
+        write_binary(stream, values.data() + it->offset, it->num_values);
+    }
+
+    write_binary<int>(stream, static_cast<int>(d_lag_indices.size()));
+    for (std::size_t i = 0; i < d_lag_indices.size(); ++i)
+    {
+        write_binary<int>(stream, d_lag_indices[i]);
+        write_binary(stream, d_X.data() + NDIM * i, NDIM);
+    }
+    stream.close();
+    if (!stream)
+    {
+        d_error_message = "could not write " + file_name;
+        return;
+    }
+
+    if (d_rank == 0)
+    {
+        std::sprintf(temp_buf, "/plot.%05d.summary", d_time_step_number);
+        std::ofstream summary((d_dirname + temp_buf).c_str());
+        summary << std::setprecision(16);
+        summary << "time_step_number " << d_time_step_number << "\n";
+        summary << "simulation_time " << d_simulation_time << "\n";
+        summary << "num_ranks " << d_num_ranks << "\n";
+        summary.close();
+        if (!summary) d_error_message = "could not write " + d_dirname + temp_buf;
+    }
+    return;
+} // writeFiles
+
+} // namespace IBAMR
@@ -0,0 +1,139 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_AsyncPlotDataWriter
+#define included_AsyncPlotDataWriter
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include "PatchDataSnapshot.h"
+
+#include <ibtk/LDataManager.h>
+
+#include <PatchHierarchy.h>
+#include <tbox/Pointer.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace IBAMR
+{
+/*!
+ * \brief Class AsyncPlotDataWriter writes visualization data from a background thread while the time
+ * stepping continues.
+ *
+ * The VisIt and Silo writers of SAMRAI and IBTK are collective and read the live hierarchy, so every rank waits
+ * for the file system at each dump. writePlotData() instead copies the interior values of the registered cell
+ * and side centered patch data, and the positions of the Lagrangian points of the finest level, into buffers of
+ * this object. A background thread then writes the copy of each rank to its own file with plain C++ streams
+ * (no MPI, HDF5 or SAMRAI calls), and writePlotData() returns as soon as the copy is made. The next call to
+ * writePlotData(), or waitForCompletion(), waits for the previous files to be complete.
+ *
+ * Each rank writes dirname/plot.NNNNN.RRRRR.bin (NNNNN the time step number, RRRRR the rank) in the native byte
+ * order, in this sequence:
+ *
+ * - the 8 characters EEL2DPLT, then int32 version, dimension, time step number, rank, number of ranks and
+ *   float64 time;
+ * - int32 number of variables, and for each: int32 name length, the name, int32 centering (0 cell, 1 side)
+ *   and int32 depth;
+ * - int32 number of patches, and for each: int32 level number, variable number, lower and upper cell index
+ *   of the patch box, float64 lower corner and mesh width of the patch, int64 number of values, then the
+ *   values: for cell data depth blocks over the cells of the box, for side data for each axis depth blocks
+ *   over the sides normal to that axis, the first index varying fastest;
+ * - int32 number of Lagrangian points, then for each int32 Lagrangian index and float64 position.
+ *
+ * Rank 0 also writes dirname/plot.NNNNN.summary, a text file with the time and the number of ranks.
+ */
+class AsyncPlotDataWriter
+{
+public:
+    /*!
+     * \brief Constructor; creates the output directory.
+     */
+    AsyncPlotDataWriter(const std::string& object_name, const std::string& dirname);
+
+    /*!
+     * \brief Destructor; waits for the files being written.
+     */
+    ~AsyncPlotDataWriter();
+
+    /*!
+     * \brief Register cell or side centered double precision patch data to be written under the given name.
+     */
+    void registerPlotData(const std::string& name, const int patch_data_idx);
+
+    /*!
+     * \brief Wait for the previous dump to be written, copy the registered patch data and the Lagrangian
+     * positions, and start writing them in the background.
+     */
+    void writePlotData(SAMRAI::tbox::Pointer<SAMRAI::hier::PatchHierarchy<NDIM> > hierarchy,
+                       IBTK::LDataManager* l_data_manager,
+                       const int time_step_number,
+                       const double simulation_time);
+
+    /*!
+     * \brief Block until the files of the last dump are complete.
+     */
+    void waitForCompletion();
+
+    /*!
+     * \brief Whether the files of a dump are still being written.
+     */
+    bool isWriting() const
+    {
+        return d_thread.joinable();
+    }
+
+private:
+    /*!
+     * \brief Default constructor (not implemented).
+     */
+    AsyncPlotDataWriter();
+
+    /*!
+     * \brief Copy constructor (not implemented).
+     */
+    AsyncPlotDataWriter(const AsyncPlotDataWriter& from);
+
+    /*!
+     * \brief Assignment operator (not implemented).
+     */
+    AsyncPlotDataWriter& operator=(const AsyncPlotDataWriter& that);
+
+    /*!
+     * \brief Write the copied data; runs on the background thread.
+     */
+    void writeFiles();
+
+    std::string d_object_name, d_dirname;
+    int d_rank, d_num_ranks;
+
+    /*!
+     * Copy of the data of one dump. Like the patch data buffers, the Lagrangian buffers keep their capacity
+     * between dumps. They are only read by the background thread.
+     */
+    int d_time_step_number;
+    double d_simulation_time;
+    PatchDataSnapshot d_snapshot;
+    std::vector<int> d_lag_indices;
+    std::vector<double> d_X;
+
+    std::thread d_thread;
+    std::string d_error_message;
+
+}; // AsyncPlotDataWriter
+
+} // namespace IBAMR
+
+#endif // #ifndef included_AsyncPlotDataWriter
@@ -0,0 +1,98 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+//////////////////////////// INCLUDES /////////////////////////////////////////
+
+#include "CurvatureBackbone.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace IBAMR
+{
+CurvatureBackbone::CurvatureBackbone() : d_initial_tangent_angle(0.0)
+{
+    return;
+} // CurvatureBackbone
+
+void
+CurvatureBackbone::setArcLength(const std::vector<double>& s)
+{
+    d_arc_length = s;
+    d_curvature.assign(s.size(), 0.0);
+    return;
+} // setArcLength
+
+void
+CurvatureBackbone::setUniformCurvature(const double kappa)
+{
+    std::fill(d_curvature.begin(), d_curvature.end(), kappa);
+    return;
+} // setUniformCurvature
+
+void
+CurvatureBackbone::integrate(double* x, double* y, double* tx, double* ty) const
+{
+    const int num_sections = getNumberOfSections();
+    if (num_sections == 0) return;
+
+    double X = d_arc_length[0], Y = 0.0;
+    double Tx = std::cos(d_initial_tangent_angle), Ty = std::sin(d_initial_tangent_angle);
+    x[0] = X;
+    y[0] = Y;
+    tx[0] = Tx;
+    ty[0] = Ty;
+
+    // Rotation of the current segment; reused while the turning angle does not change.
+    double phi = 0.0, cos_phi = 1.0, sin_phi = 0.0, chord_t = 1.0, chord_n = 0.0;
+    for (int i = 1; i < num_sections; ++i)
+    {
+        const double ds = d_arc_length[i] - d_arc_length[i - 1];
+        const double segment_phi = 0.5 * (d_curvature[i - 1] + d_curvature[i]) * ds;
+        if (segment_phi != phi)
+        {
+            phi = segment_phi;
+            cos_phi = std::cos(phi);
+            sin_phi = std::sin(phi);
+
+            // Chord of the arc per unit arc length along the tangent, sin(phi)/phi, and along the normal,
+            // (1 - cos(phi))/phi, with their Taylor expansions for small turning angles.
+            if (std::abs(phi) < 1.0e-4)
+            {
+                chord_t = 1.0 - phi * phi / 6.0;
+                chord_n = 0.5 * phi * (1.0 - phi * phi / 12.0);
+            }
+            else
+            {
+                chord_t = sin_phi / phi;
+                chord_n = (1.0 - cos_phi) / phi;
+            }
+        }
+
+        // Advance along the arc from the current tangent and normal (-Ty, Tx), then rotate the tangent.
+        X += ds * (chord_t * Tx - chord_n * Ty);
+        Y += ds * (chord_t * Ty + chord_n * Tx);
+        const double Tx_new = cos_phi * Tx - sin_phi * Ty;
+        Ty = sin_phi * Tx + cos_phi * Ty;
+        Tx = Tx_new;
+
+        x[i] = X;
+        y[i] = Y;
+        tx[i] = Tx;
+        ty[i] = Ty;
+    }
+
+    return;
+} // integrate
+
+} // namespace IBAMR
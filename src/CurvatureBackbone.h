@@ -0,0 +1,109 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_CurvatureBackbone
+#define included_CurvatureBackbone
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include <vector>
+
+namespace IBAMR
+{
+/*!
+ * \brief Class CurvatureBackbone builds a planar backbone curve from its curvature kappa(s) given at a set
+ * of arc lengths.
+ *
+ * The Frenet equations x' = t, t' = kappa*n, with unit normal n = (-t_y, t_x), are integrated section by
+ * section starting from x = (s_0, 0) and t = (cos(a_0), sin(a_0)), where the initial tangent angle a_0 is 0
+ * unless set otherwise. Over each segment the curvature is taken to be the
+ * mean of its end values, for which the segment is an exact circular arc: the tangent is advanced by a
+ * rotation and the position by the exact chord of the arc. The unit tangent is carried along directly, so
+ * no angles are reconstructed from coordinates. A straight backbone (kappa = 0) and a circular arc of
+ * radius R (kappa = 1/R) are reproduced to round-off, and the rotation of consecutive segments with equal
+ * turning angle is computed only once.
+ */
+class CurvatureBackbone
+{
+public:
+    /*!
+     * \brief Default constructor (no sections).
+     */
+    CurvatureBackbone();
+
+    /*!
+     * \brief Set the arc lengths of the sections and allocate their curvature.
+     */
+    void setArcLength(const std::vector<double>& s);
+
+    /*!
+     * \brief Curvature at each section, to be filled in before integrate().
+     */
+    double* getCurvature()
+    {
+        return d_curvature.data();
+    }
+
+    /*!
+     * \brief Set the same curvature at all sections.
+     */
+    void setUniformCurvature(const double kappa);
+
+    /*!
+     * \brief Set the angle of the tangent at the first section.
+     */
+    void setInitialTangentAngle(const double angle)
+    {
+        d_initial_tangent_angle = angle;
+    }
+
+    /*!
+     * \brief Initial tangent angle that makes a backbone of uniform curvature kappa symmetric about a chord
+     * along x, i.e. a circular arc whose first and last sections have the same y coordinate.
+     */
+    double getSymmetricArcTangentAngle(const double kappa) const
+    {
+        return d_arc_length.empty() ? 0.0 : -0.5 * kappa * (d_arc_length.back() - d_arc_length.front());
+    }
+
+    /*!
+     * \brief Integrate the backbone coordinates and unit tangents at all sections.
+     *
+     * \note All output arrays must hold getNumberOfSections() entries.
+     */
+    void integrate(double* x, double* y, double* tx, double* ty) const;
+
+    /*!
+     * \brief Number of backbone sections.
+     */
+    int getNumberOfSections() const
+    {
+        return static_cast<int>(d_arc_length.size());
+    }
+
+private:
+    /*!
+     * Arc length and curvature of each section.
+     */
+    std::vector<double> d_arc_length, d_curvature;
+
+    /*!
+     * Angle of the tangent at the first section.
+     */
+    double d_initial_tangent_angle;
+
+}; // CurvatureBackbone
+
+} // namespace IBAMR
+
+#endif // #ifndef included_CurvatureBackbone
@@ -0,0 +1,103 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+//////////////////////////// INCLUDES /////////////////////////////////////////
+
+#include "CycleStatistics.h"
+
+#include <stdexcept>
+
+namespace IBAMR
+{
+namespace
+{
+// Values in the state vector: the phase, the start time, the number of completed cycles and their start and end
+// times, and three values per running statistic of the current and the completed cycle.
+static const int STATE_SIZE = 5 + 6 * CycleStatistics::NUM_QUANTITIES;
+
+} // namespace
+
+CycleStatistics::CycleStatistics()
+    : d_phase(0.0), d_start_time(0.0), d_num_completed_cycles(0), d_completed_start_time(0.0), d_completed_end_time(0.0)
+{
+    return;
+} // CycleStatistics
+
+bool
+CycleStatistics::addSample(const double time, const double dt, const double frequency, const double* values)
+{
+    // A cycle starts with its first step.
+    if (d_current[0].getWeight() == 0.0) d_start_time = time - dt;
+    for (int q = 0; q < NUM_QUANTITIES; ++q) d_current[q].add(values[q], dt);
+
+    const double old_phase = d_phase;
+    d_phase += frequency * dt;
+    if (std::floor(d_phase) <= std::floor(old_phase)) return false;
+
+    for (int q = 0; q < NUM_QUANTITIES; ++q)
+    {
+        d_completed[q] = d_current[q];
+        d_current[q].reset();
+    }
+    ++d_num_completed_cycles;
+    d_completed_start_time = d_start_time;
+    d_completed_end_time = time;
+    return true;
+} // addSample
+
+double
+CycleStatistics::getCompletedCycleStrouhalNumber() const
+{
+    const double speed = d_completed[SWIMMING_SPEED].getMean();
+    if (speed <= 0.0) return 0.0;
+    return d_completed[FREQUENCY].getMean() * d_completed[AMPLITUDE].getMean() / speed;
+} // getCompletedCycleStrouhalNumber
+
+void
+CycleStatistics::getState(std::vector<double>& state) const
+{
+    state.resize(STATE_SIZE);
+    state[0] = d_phase;
+    state[1] = d_start_time;
+    state[2] = d_num_completed_cycles;
+    state[3] = d_completed_start_time;
+    state[4] = d_completed_end_time;
+    for (int q = 0; q < NUM_QUANTITIES; ++q)
+    {
+        d_current[q].getState(&state[5 + 3 * q]);
+        d_completed[q].getState(&state[5 + 3 * (NUM_QUANTITIES + q)]);
+    }
+    return;
+} // getState
+
+void
+CycleStatistics::setState(const std::vector<double>& state)
+{
+    if (static_cast<int>(state.size()) != STATE_SIZE)
+    {
+        throw std::invalid_argument("CycleStatistics: the restart state has the wrong size");
+    }
+    d_phase = state[0];
+    d_start_time = state[1];
+    d_num_completed_cycles = static_cast<int>(state[2]);
+    d_completed_start_time = state[3];
+    d_completed_end_time = state[4];
+    for (int q = 0; q < NUM_QUANTITIES; ++q)
+    {
+        d_current[q].setState(&state[5 + 3 * q]);
+        d_completed[q].setState(&state[5 + 3 * (NUM_QUANTITIES + q)]);
+    }
+    return;
+} // setState
+
+} // namespace IBAMR
@@ -0,0 +1,186 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_CycleStatistics
+#define included_CycleStatistics
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include <cmath>
+#include <vector>
+
+namespace IBAMR
+{
+/*!
+ * \brief Class RunningStatistics accumulates the weighted mean and variance of a stream of samples in one pass.
+ *
+ * The update is West's weighted form of Welford's algorithm, which avoids the cancellation of the sum of
+ * squares formula when the fluctuations are small compared with the mean.
+ */
+class RunningStatistics
+{
+public:
+    /*!
+     * \brief Constructor; no samples.
+     */
+    RunningStatistics() : d_weight(0.0), d_mean(0.0), d_sum_sq(0.0)
+    {
+    }
+
+    /*!
+     * \brief Forget all samples.
+     */
+    void reset()
+    {
+        d_weight = d_mean = d_sum_sq = 0.0;
+    }
+
+    /*!
+     * \brief Add a sample with a positive weight.
+     */
+    void add(const double x, const double weight)
+    {
+        d_weight += weight;
+        const double delta = x - d_mean;
+        d_mean += (weight / d_weight) * delta;
+        d_sum_sq += weight * delta * (x - d_mean);
+    }
+
+    /*!
+     * \brief Total weight, weighted mean and (population) variance of the samples.
+     */
+    double getWeight() const
+    {
+        return d_weight;
+    }
+    double getMean() const
+    {
+        return d_mean;
+    }
+    double getVariance() const
+    {
+        return d_weight > 0.0 ? d_sum_sq / d_weight : 0.0;
+    }
+    double getStandardDeviation() const
+    {
+        return std::sqrt(getVariance());
+    }
+
+    /*!
+     * \brief Copy the state to and from three values, for restart files.
+     */
+    void getState(double* state) const
+    {
+        state[0] = d_weight;
+        state[1] = d_mean;
+        state[2] = d_sum_sq;
+    }
+    void setState(const double* state)
+    {
+        d_weight = state[0];
+        d_mean = state[1];
+        d_sum_sq = state[2];
+    }
+
+private:
+    double d_weight, d_mean, d_sum_sq;
+
+}; // RunningStatistics
+
+/*!
+ * \brief Class CycleStatistics accumulates the time-weighted mean and variance of the performance metrics of a
+ * swimmer over each tail-beat cycle.
+ *
+ * The cycles are counted by the phase, the time integral of the tail-beat frequency, so they follow the frequency
+ * when it changes. Each sample covers a time step and is weighted by its length; the step in which the phase
+ * crosses a whole number completes the cycle. The statistics of the last completed cycle stay available until
+ * the next one is completed.
+ */
+class CycleStatistics
+{
+public:
+    /*!
+     * \brief The quantities sampled at each step.
+     */
+    enum Quantity
+    {
+        SWIMMING_SPEED = 0,
+        THRUST,
+        POWER,
+        EFFICIENCY,
+        AMPLITUDE,
+        FREQUENCY,
+        NUM_QUANTITIES
+    };
+
+    /*!
+     * \brief Constructor; no samples and phase zero.
+     */
+    CycleStatistics();
+
+    /*!
+     * \brief Add the values of the quantities over the time step of length dt that ended at time, with the
+     * tail-beat frequency of the step. Returns true if the step completed a cycle.
+     */
+    bool addSample(const double time, const double dt, const double frequency, const double* values);
+
+    /*!
+     * \brief Number of cycles completed so far.
+     */
+    int getNumberOfCompletedCycles() const
+    {
+        return d_num_completed_cycles;
+    }
+
+    /*!
+     * \brief Start and end time and statistics of a quantity of the last completed cycle.
+     */
+    double getCompletedCycleStartTime() const
+    {
+        return d_completed_start_time;
+    }
+    double getCompletedCycleEndTime() const
+    {
+        return d_completed_end_time;
+    }
+    const RunningStatistics& getCompletedCycle(const Quantity q) const
+    {
+        return d_completed[q];
+    }
+
+    /*!
+     * \brief Strouhal number f*A/U of the last completed cycle, from its mean frequency, amplitude and
+     * swimming speed (0 while the mean speed vanishes).
+     */
+    double getCompletedCycleStrouhalNumber() const;
+
+    /*!
+     * \brief Copy the state of the current and the last completed cycle to and from a vector, for restart
+     * files.
+     */
+    void getState(std::vector<double>& state) const;
+    void setState(const std::vector<double>& state);
+
+private:
+    double d_phase, d_start_time;
+    RunningStatistics d_current[NUM_QUANTITIES];
+
+    int d_num_completed_cycles;
+    double d_completed_start_time, d_completed_end_time;
+    RunningStatistics d_completed[NUM_QUANTITIES];
+
+}; // CycleStatistics
+
+} // namespace IBAMR
+
+#endif // #ifndef included_CycleStatistics
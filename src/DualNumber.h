@@ -0,0 +1,156 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_DualNumber
+#define included_DualNumber
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include <cmath>
+
+namespace IBAMR
+{
+/*!
+ * \brief Struct DualNumber is a forward-mode automatic differentiation number a + b*eps with eps^2 = 0.
+ *
+ * Evaluating a function on DualNumber(x, 1) yields f(x) in val and f'(x) in der.
+ *
+ * The arithmetic operators and math functions are hidden friends: they are found by argument-dependent
+ * lookup on DualNumber arguments only, and never shadow the std:: or global functions of plain doubles.
+ */
+struct DualNumber
+{
+    DualNumber(const double value = 0.0, const double derivative = 0.0) : val(value), der(derivative)
+    {
+    }
+
+    friend inline DualNumber operator+(const DualNumber& a, const DualNumber& b)
+    {
+        return DualNumber(a.val + b.val, a.der + b.der);
+    }
+
+    friend inline DualNumber operator-(const DualNumber& a, const DualNumber& b)
+    {
+        return DualNumber(a.val - b.val, a.der - b.der);
+    }
+
+    friend inline DualNumber operator-(const DualNumber& a)
+    {
+        return DualNumber(-a.val, -a.der);
+    }
+
+    friend inline DualNumber operator*(const DualNumber& a, const DualNumber& b)
+    {
+        return DualNumber(a.val * b.val, a.der * b.val + a.val * b.der);
+    }
+
+    friend inline DualNumber operator/(const DualNumber& a, const DualNumber& b)
+    {
+        return DualNumber(a.val / b.val, (a.der * b.val - a.val * b.der) / (b.val * b.val));
+    }
+
+    friend inline DualNumber sin(const DualNumber& a)
+    {
+        return DualNumber(std::sin(a.val), a.der * std::cos(a.val));
+    }
+
+    friend inline DualNumber cos(const DualNumber& a)
+    {
+        return DualNumber(std::cos(a.val), -a.der * std::sin(a.val));
+    }
+
+    friend inline DualNumber tan(const DualNumber& a)
+    {
+        const double t = std::tan(a.val);
+        return DualNumber(t, a.der * (1.0 + t * t));
+    }
+
+    friend inline DualNumber asin(const DualNumber& a)
+    {
+        return DualNumber(std::asin(a.val), a.der / std::sqrt(1.0 - a.val * a.val));
+    }
+
+    friend inline DualNumber acos(const DualNumber& a)
+    {
+        return DualNumber(std::acos(a.val), -a.der / std::sqrt(1.0 - a.val * a.val));
+    }
+
+    friend inline DualNumber atan(const DualNumber& a)
+    {
+        return DualNumber(std::atan(a.val), a.der / (1.0 + a.val * a.val));
+    }
+
+    friend inline DualNumber sinh(const DualNumber& a)
+    {
+        return DualNumber(std::sinh(a.val), a.der * std::cosh(a.val));
+    }
+
+    friend inline DualNumber cosh(const DualNumber& a)
+    {
+        return DualNumber(std::cosh(a.val), a.der * std::sinh(a.val));
+    }
+
+    friend inline DualNumber tanh(const DualNumber& a)
+    {
+        const double t = std::tanh(a.val);
+        return DualNumber(t, a.der * (1.0 - t * t));
+    }
+
+    friend inline DualNumber exp(const DualNumber& a)
+    {
+        const double e = std::exp(a.val);
+        return DualNumber(e, a.der * e);
+    }
+
+    friend inline DualNumber log(const DualNumber& a)
+    {
+        return DualNumber(std::log(a.val), a.der / a.val);
+    }
+
+    friend inline DualNumber log10(const DualNumber& a)
+    {
+        return DualNumber(std::log10(a.val), a.der / (a.val * std::log(10.0)));
+    }
+
+    friend inline DualNumber log2(const DualNumber& a)
+    {
+        return DualNumber(std::log2(a.val), a.der / (a.val * std::log(2.0)));
+    }
+
+    friend inline DualNumber sqrt(const DualNumber& a)
+    {
+        const double r = std::sqrt(a.val);
+        return DualNumber(r, a.der / (2.0 * r));
+    }
+
+    friend inline DualNumber abs(const DualNumber& a)
+    {
+        return a.val < 0.0 ? -a : a;
+    }
+
+    friend inline DualNumber pow(const DualNumber& a, const DualNumber& b)
+    {
+        const double p = std::pow(a.val, b.val);
+        // d(a^b) = b*a^(b-1)*da + a^b*ln(a)*db; the second term is skipped for constant exponents so that
+        // negative bases with integer exponents stay well defined.
+        double der = (a.der == 0.0) ? 0.0 : b.val * std::pow(a.val, b.val - 1.0) * a.der;
+        if (b.der != 0.0) der += p * std::log(a.val) * b.der;
+        return DualNumber(p, der);
+    }
+
+    double val, der;
+};
+
+} // namespace IBAMR
+
+#endif // #ifndef included_DualNumber
@@ -0,0 +1,867 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+//////////////////////////// INCLUDES /////////////////////////////////////////
+
+#include "EelKinematics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace IBAMR
+{
+namespace
+{
+inline int
+sign(const double X)
+{
+    return ((X > 0) ? 1 : ((X < 0) ? -1 : 0));
+}
+
+static const double PII = 3.1415926535897932384626433832795;
+static const double __INFINITY = 1e9;
+
+// Set Fish Related Parameters.
+static const double LENGTH_FISH = 1.0;
+static const double WIDTH_HEAD = 0.04 * LENGTH_FISH;
+static const double LENGTH_HEAD = 0.04;
+
+// prey capturing parameters.
+static const double CUT_OFF_ANGLE = PII / 4;
+static const double CUT_OFF_RADIUS = 0.7;
+static const double LOWER_CUT_OFF_ANGLE = 7 * PII / 180;
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////
+
+EelKinematics::EelKinematics(const int num_workers,
+                             const std::vector<std::string>& constant_names,
+                             const std::vector<double>& constant_values)
+    : d_constant_names(constant_names),
+      d_contexts(std::max(num_workers, 1)),
+      d_use_specialized_kernels(true),
+      d_section_velocity_kernel(nullptr),
+      d_section_shape_kernel(nullptr),
+      d_shape_com_x(0.0),
+      d_shape_com_y(0.0),
+      d_velocity(DIM),
+      d_shape(DIM),
+      d_kinematics_type(PARSER_KINEMATICS),
+      d_deformation_time(-std::numeric_limits<double>::max()),
+      d_use_shape_cache(false),
+      d_shape_cache_num_phases(0),
+      d_shape_cache_check_interval(0),
+      d_shape_cache_num_updates(0),
+      d_shape_cache_period(0.0),
+      d_shape_cache_tolerance(0.0),
+      d_shape_cache_initial_error(0.0),
+      d_shape_cache_check_failed(false),
+      d_shape_cache_check_error(0.0),
+      d_shape_cache_check_time(0.0),
+      d_body_is_maneuvering(false),
+      d_maneuver_axis_has_curvature_law(false),
+      d_maneuver_axis_is_changing_shape(false),
+      d_initial_angle(0.0)
+{
+    if (constant_names.size() != constant_values.size())
+    {
+        throw std::invalid_argument("EelKinematics: the numbers of constant names and values differ");
+    }
+    for (std::vector<EvaluationContext>::iterator it = d_contexts.begin(); it != d_contexts.end(); ++it)
+    {
+        it->variables.constants = constant_values;
+    }
+    d_mesh_width.fill(0.0);
+    d_food_location.fill(0.0);
+    selectSectionKernels();
+    return;
+} // EelKinematics
+
+void
+EelKinematics::setKinematicsType(const KinematicsType type, const TravelingWaveKinematics& traveling_wave)
+{
+    d_kinematics_type = type;
+    d_traveling_wave = traveling_wave;
+    selectSectionKernels();
+    return;
+} // setKinematicsType
+
+bool
+EelKinematics::setFunction(const int function, const std::string& expression)
+{
+    KinematicsFunction& f = d_functions[function];
+    f.expression = expression;
+    f.is_used = true;
+    try
+    {
+        f.compiled = KinematicsExpression(expression, DIM, d_constant_names);
+        f.is_compiled = true;
+        f.compile_error.clear();
+    }
+    catch (const std::invalid_argument& e)
+    {
+        f.is_compiled = false;
+        f.compile_error = e.what();
+    }
+    return f.is_compiled;
+} // setFunction
+
+void
+EelKinematics::setFallbackFunction(const int function, const int worker, const FallbackFunction& fallback)
+{
+    d_contexts[worker].fallbacks[function] = fallback;
+    return;
+} // setFallbackFunction
+
+void
+EelKinematics::setManeuvering(const bool body_is_maneuvering,
+                              const bool axis_has_curvature_law,
+                              const bool axis_is_changing_shape)
+{
+    if (body_is_maneuvering && axis_has_curvature_law && axis_is_changing_shape)
+    {
+        throw std::invalid_argument(
+            "EelKinematics: a maneuvering axis curvature law cannot be combined with an axis that changes shape");
+    }
+    d_body_is_maneuvering = body_is_maneuvering;
+    d_maneuver_axis_has_curvature_law = body_is_maneuvering && axis_has_curvature_law;
+    d_maneuver_axis_is_changing_shape = body_is_maneuvering && axis_is_changing_shape;
+    selectSectionKernels();
+    return;
+} // setManeuvering
+
+void
+EelKinematics::setFoodLocation(const double* food_location)
+{
+    for (int d = 0; d < DIM; ++d) d_food_location[d] = food_location[d];
+    return;
+} // setFoodLocation
+
+void
+EelKinematics::setShapeCache(const int num_phases,
+                             const double period,
+                             const double tolerance,
+                             const int check_interval)
+{
+    if (d_kinematics_type == PARSER_KINEMATICS)
+    {
+        throw std::invalid_argument("EelKinematics: the shape cache requires TRAVELING_WAVE or AUTODIFF kinematics");
+    }
+    if (num_phases < 2)
+    {
+        throw std::invalid_argument("EelKinematics: the shape cache needs at least 2 phases");
+    }
+    d_use_shape_cache = true;
+    d_shape_cache_num_phases = num_phases;
+    d_shape_cache_period = period;
+    d_shape_cache_tolerance = tolerance;
+    d_shape_cache_check_interval = check_interval;
+    return;
+} // setShapeCache
+
+void
+EelKinematics::setUseSpecializedKernels(const bool use_specialized_kernels)
+{
+    d_use_specialized_kernels = use_specialized_kernels;
+    selectSectionKernels();
+    return;
+} // setUseSpecializedKernels
+
+int
+EelKinematics::setBodyLayout(const double* mesh_width, const double time)
+{
+    for (int d = 0; d < DIM; ++d) d_mesh_width[d] = mesh_width[d];
+
+    // No. of points on the backbone and till head.
+    const int BodyNx = static_cast<int>(ceil(LENGTH_FISH / d_mesh_width[0]));
+    const int HeadNx = static_cast<int>(ceil(LENGTH_HEAD / d_mesh_width[0]));
+
+    d_sections.resize(BodyNx);
+    for (int i = 1; i <= HeadNx; ++i)
+    {
+        const double s = (i - 1) * d_mesh_width[0];
+        const double section = sqrt(2 * WIDTH_HEAD * s - s * s);
+        const int NumPtsInSection = 2 * static_cast<int>(ceil(section / d_mesh_width[1]));
+        d_sections.s[i - 1] = s;
+        d_sections.num_pts[i - 1] = NumPtsInSection;
+    }
+
+    for (int i = HeadNx + 1; i <= BodyNx; ++i)
+    {
+        const double s = (i - 1) * d_mesh_width[0];
+        const double section = WIDTH_HEAD * (LENGTH_FISH - s) / (LENGTH_FISH - LENGTH_HEAD);
+        const int NumPtsInHeight = 2 * static_cast<int>(ceil(section / d_mesh_width[1]));
+        d_sections.s[i - 1] = s;
+        d_sections.num_pts[i - 1] = NumPtsInHeight;
+    }
+    d_sections.computeOffsets();
+    partitionSections();
+    d_section_com_x.resize(BodyNx);
+    d_section_com_y.resize(BodyNx);
+
+    const int total_lag_pts = d_sections.getNumberOfPoints();
+    for (int d = 0; d < DIM; ++d)
+    {
+        d_velocity[d].resize(total_lag_pts);
+        d_shape[d].resize(total_lag_pts);
+    }
+
+    // Tabulate the time-independent part of the traveling wave at each section, and allocate the per-section
+    // deformation (and its rate for the non-parser modes).
+    if (d_kinematics_type == TRAVELING_WAVE_KINEMATICS)
+    {
+        d_traveling_wave.setBackbone(d_sections.s);
+    }
+    d_section_deformation.resize(BodyNx);
+    if (d_kinematics_type != PARSER_KINEMATICS)
+    {
+        d_section_deformation_rate.resize(BodyNx);
+        d_deformation_time = -std::numeric_limits<double>::max();
+    }
+
+    // Tabulate the periodic deformation over one cycle.
+    if (d_use_shape_cache) initializeShapeCache();
+
+    // Find the coordinates of the axis of maneuvering in the reference frame.
+    if (d_body_is_maneuvering)
+    {
+        d_maneuver_backbone.setArcLength(d_sections.s);
+        if (d_maneuver_axis_has_curvature_law)
+        {
+            integrateManeuverAxis(time);
+        }
+        else
+        {
+            const double* posn[DIM] = { nullptr };
+            posn[0] = d_sections.s.data();
+            evaluateFunction(
+                MANEUVERING_AXIS_FUNCTION, d_contexts[0], BodyNx, posn, nullptr, d_sections.reference_axis_y.data());
+            for (int i = 0; i < BodyNx; ++i) d_sections.reference_axis_x[i] = d_sections.s[i];
+
+            // Store the tangents to the reference maneuver axis and shift its COM to the origin.
+            centerManeuverAxisAndCalculateTangents();
+        }
+    } // body is maneuvering
+
+    return total_lag_pts;
+} // setBodyLayout
+
+void
+EelKinematics::updateManeuverAxis(const double time,
+                                  const double incremented_angle,
+                                  const double* center_of_mass,
+                                  const double* tagged_pt_position)
+{
+    if (!d_body_is_maneuvering) return;
+
+    // Re-integrate an axis given by a time-dependent curvature law.
+    if (d_maneuver_axis_has_curvature_law) integrateManeuverAxis(time);
+
+    if (d_maneuver_axis_is_changing_shape)
+    {
+        // calculate the radius of the circular path on which the fish will have its backbone.
+        double radius_circular_path;
+        std::array<double, DIM> bodyline_vector, foodline_vector;
+        double mag_bodyline_vector = 0.0, mag_foodline_vector = 0.0;
+
+        for (int dim = 0; dim < DIM; ++dim)
+        {
+            bodyline_vector[dim] = tagged_pt_position[dim] - center_of_mass[dim];
+            foodline_vector[dim] = d_food_location[dim] - tagged_pt_position[dim];
+            mag_bodyline_vector += std::pow(bodyline_vector[dim], 2);
+            mag_foodline_vector += std::pow(foodline_vector[dim], 2);
+        }
+
+        // Normalize the vectors.
+        for (int dim = 0; dim < DIM; ++dim)
+        {
+            bodyline_vector[dim] /= sqrt(mag_bodyline_vector);
+            foodline_vector[dim] /= sqrt(mag_foodline_vector);
+        }
+
+        // Find the angle between bodyline_axis and foodline_axis
+        // angle = sign(aXb)* acos(a.b/|a||b|)
+        const double angle_bw_target_vision =
+            sign(bodyline_vector[0] * foodline_vector[1] - bodyline_vector[1] * foodline_vector[0]) *
+            std::acos(bodyline_vector[0] * foodline_vector[0] + bodyline_vector[1] * foodline_vector[1]);
+
+        if (angle_bw_target_vision >= CUT_OFF_ANGLE)
+        {
+            radius_circular_path = CUT_OFF_RADIUS;
+        }
+        else if (angle_bw_target_vision <= -CUT_OFF_ANGLE)
+        {
+            radius_circular_path = CUT_OFF_RADIUS;
+        }
+        else if (std::abs(angle_bw_target_vision) < std::sqrt(std::numeric_limits<double>::epsilon()))
+        {
+            radius_circular_path = __INFINITY;
+        }
+        else if (angle_bw_target_vision >= -LOWER_CUT_OFF_ANGLE && angle_bw_target_vision <= LOWER_CUT_OFF_ANGLE)
+        {
+            radius_circular_path = std::abs(CUT_OFF_RADIUS * std::pow((CUT_OFF_ANGLE / LOWER_CUT_OFF_ANGLE), 1));
+        }
+        else
+        {
+            radius_circular_path = std::abs(CUT_OFF_RADIUS * std::pow((CUT_OFF_ANGLE / angle_bw_target_vision), 1));
+        }
+        // The backbone follows a circular arc of this radius, i.e. it has constant curvature, and is straight
+        // when the food lies ahead. As before, the arc is symmetric about a chord along the x axis, so the body
+        // frame does not rotate with the radius.
+        const double kappa = radius_circular_path != __INFINITY ? -1.0 / radius_circular_path : 0.0;
+        d_maneuver_backbone.setUniformCurvature(kappa);
+        d_maneuver_backbone.setInitialTangentAngle(d_maneuver_backbone.getSymmetricArcTangentAngle(kappa));
+
+        // Integrate this reference axis and its tangents for shape update and shift its COM to the origin.
+        integrateManeuverAxis(time);
+    } // maneuverAxisIsChangingShape
+
+    // Rotate the reference axis and calculate tangents in the rotated frame.
+    transformManeuverAxisAndCalculateTangents(d_initial_angle + incremented_angle);
+
+    return;
+} // updateManeuverAxis
+
+void
+EelKinematics::setVelocity(const double time, const double incremented_angle)
+{
+    if (d_kinematics_type != PARSER_KINEMATICS) updateSectionDeformation(time);
+
+    // Set the deformation velocity in the body frame, each worker handling its own block of sections.
+    const double angleFromHorizontal = d_initial_angle + incremented_angle;
+    const double cos_angle = cos(angleFromHorizontal);
+    const double sin_angle = sin(angleFromHorizontal);
+    const int num_workers = static_cast<int>(d_contexts.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(num_workers) if (num_workers > 1)
+#endif
+    for (int k = 0; k < num_workers; ++k)
+    {
+        d_contexts[k].variables.time = time;
+        (this->*d_section_velocity_kernel)(
+            d_section_partition[k], d_section_partition[k + 1], cos_angle, sin_angle, d_contexts[k]);
+    }
+
+    return;
+} // setVelocity
+
+void
+EelKinematics::generateShape(const double time)
+{
+    if (d_kinematics_type != PARSER_KINEMATICS) updateSectionDeformation(time);
+
+    // Generate the body-frame shape, each worker handling its own block of sections.
+    const int num_workers = static_cast<int>(d_contexts.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(num_workers) if (num_workers > 1)
+#endif
+    for (int k = 0; k < num_workers; ++k)
+    {
+        d_contexts[k].variables.time = time;
+        (this->*d_section_shape_kernel)(d_section_partition[k], d_section_partition[k + 1], d_contexts[k]);
+    }
+
+    // Add up the c.m. in section order, independently of the partition.
+    double com_x = 0.0, com_y = 0.0;
+    const int num_sections = d_sections.size();
+    for (int section_idx = 0; section_idx < num_sections; ++section_idx)
+    {
+        com_x += d_section_com_x[section_idx];
+        com_y += d_section_com_y[section_idx];
+    }
+    const int total_lag_pts = d_sections.getNumberOfPoints();
+    d_shape_com_x = com_x / total_lag_pts;
+    d_shape_com_y = com_y / total_lag_pts;
+
+    return;
+} // generateShape
+
+void
+EelKinematics::transformShape(const double incremented_angle)
+{
+    // Shift the c.m. to the origin and rotate the shape about it as a single affine transform.
+    const double angleFromHorizontal = d_initial_angle + incremented_angle;
+    const double cos_angle = cos(angleFromHorizontal);
+    const double sin_angle = sin(angleFromHorizontal);
+    const int num_workers = static_cast<int>(d_contexts.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(num_workers) if (num_workers > 1)
+#endif
+    for (int k = 0; k < num_workers; ++k)
+    {
+        transformPoints(d_sections.offset[d_section_partition[k]],
+                        d_sections.offset[d_section_partition[k + 1]],
+                        d_shape_com_x,
+                        d_shape_com_y,
+                        cos_angle,
+                        sin_angle);
+    }
+
+    return;
+} // transformShape
+
+void
+EelKinematics::updateSectionDeformation(const double time)
+{
+    // The velocity and the shape are set at the same time, so one evaluation serves both.
+    if (time == d_deformation_time) return;
+
+    if (d_use_shape_cache)
+    {
+        d_shape_cache.interpolate(time, d_section_deformation.data(), d_section_deformation_rate.data());
+
+        // Periodically verify the interpolated deformation against direct evaluation.
+        ++d_shape_cache_num_updates;
+        if (d_shape_cache_check_interval > 0 && d_shape_cache_num_updates % d_shape_cache_check_interval == 0)
+        {
+            const double error = computeShapeCacheError(time);
+            if (error > d_shape_cache_tolerance)
+            {
+                d_shape_cache_check_failed = true;
+                d_shape_cache_check_error = error;
+                d_shape_cache_check_time = time;
+            }
+        }
+    }
+    else
+    {
+        computeSectionDeformation(time, d_section_deformation.data(), d_section_deformation_rate.data());
+    }
+    d_deformation_time = time;
+
+    return;
+} // updateSectionDeformation
+
+bool
+EelKinematics::checkShapeCacheFailed(double& error, double& time)
+{
+    if (!d_shape_cache_check_failed) return false;
+    error = d_shape_cache_check_error;
+    time = d_shape_cache_check_time;
+    d_shape_cache_check_failed = false;
+    return true;
+} // checkShapeCacheFailed
+
+double
+EelKinematics::evaluateFunction(const int function, EvaluationContext& context) const
+{
+    const KinematicsFunction& f = d_functions[function];
+    return f.is_compiled ? f.compiled.evaluate(context.variables) : context.fallbacks[function]();
+} // evaluateFunction
+
+void
+EelKinematics::evaluateFunction(const int function,
+                                EvaluationContext& context,
+                                const int num_points,
+                                const double* const* posn,
+                                const double* const* normal,
+                                double* values) const
+{
+    const KinematicsFunction& f = d_functions[function];
+    if (f.is_compiled)
+    {
+        f.compiled.evaluate(context.variables, num_points, posn, normal, values);
+        return;
+    }
+
+    for (int i = 0; i < num_points; ++i)
+    {
+        for (int d = 0; d < DIM; ++d)
+        {
+            if (posn && posn[d]) context.variables.posn[d] = posn[d][i];
+            if (normal && normal[d]) context.variables.normal[d] = normal[d][i];
+        }
+        values[i] = context.fallbacks[function]();
+    }
+    return;
+} // evaluateFunction
+
+void
+EelKinematics::partitionSections()
+{
+    // Worker k starts at the first section whose points begin at or after k/num_workers of all points.
+    const int num_workers = static_cast<int>(d_contexts.size());
+    const int num_sections = d_sections.size();
+    const long total_lag_pts = d_sections.getNumberOfPoints();
+    d_section_partition.resize(num_workers + 1);
+    d_section_partition[0] = 0;
+    for (int k = 1; k < num_workers; ++k)
+    {
+        const long target = total_lag_pts * k / num_workers;
+        d_section_partition[k] = static_cast<int>(
+            std::lower_bound(d_sections.offset.begin(), d_sections.offset.begin() + num_sections, target) -
+            d_sections.offset.begin());
+    }
+    d_section_partition[num_workers] = num_sections;
+
+    return;
+} // partitionSections
+
+void
+EelKinematics::centerManeuverAxisAndCalculateTangents()
+{
+    const int num_sections = d_sections.size();
+    const double* const x = d_sections.reference_axis_x.data();
+    const double* const y = d_sections.reference_axis_y.data();
+    double* const tx = d_sections.reference_tangent_x.data();
+    double* const ty = d_sections.reference_tangent_y.data();
+
+    // Unit tangent of the segment joining each section to the next one.
+    for (int i = 0; i < num_sections - 1; ++i)
+    {
+        const double dX = x[i + 1] - x[i];
+        const double dY = y[i + 1] - y[i];
+        const double ds = std::sqrt(dX * dX + dY * dY);
+        tx[i] = dX / ds;
+        ty[i] = dY / ds;
+    }
+
+    // The last section uses the tangent of the last segment.
+    tx[num_sections - 1] = tx[num_sections - 2];
+    ty[num_sections - 1] = ty[num_sections - 2];
+
+    centerManeuverAxis();
+
+    return;
+
+} // centerManeuverAxisAndCalculateTangents
+
+void
+EelKinematics::centerManeuverAxis()
+{
+    const int num_sections = d_sections.size();
+    const double* const x = d_sections.reference_axis_x.data();
+    const double* const y = d_sections.reference_axis_y.data();
+
+    // Find the COM of the maneuver axis.
+    double maneuverAxis_x_cm = 0.0;
+    double maneuverAxis_y_cm = 0.0;
+    for (int i = 0; i < num_sections; ++i)
+    {
+        maneuverAxis_x_cm += x[i];
+        maneuverAxis_y_cm += y[i];
+    }
+    maneuverAxis_x_cm /= num_sections;
+    maneuverAxis_y_cm /= num_sections;
+
+    // Shift the reference so that maneuver Axis coordinate COM coincides with the origin.
+    for (int i = 0; i < num_sections; ++i)
+    {
+        d_sections.reference_axis_x[i] -= maneuverAxis_x_cm;
+        d_sections.reference_axis_y[i] -= maneuverAxis_y_cm;
+    }
+
+    return;
+
+} // centerManeuverAxis
+
+void
+EelKinematics::integrateManeuverAxis(const double time)
+{
+    if (d_maneuver_axis_has_curvature_law)
+    {
+        const double* posn[DIM] = { nullptr };
+        posn[0] = d_sections.s.data();
+        d_contexts[0].variables.time = time;
+        evaluateFunction(MANEUVERING_AXIS_CURVATURE_FUNCTION,
+                         d_contexts[0],
+                         d_sections.size(),
+                         posn,
+                         nullptr,
+                         d_maneuver_backbone.getCurvature());
+    }
+
+    d_maneuver_backbone.integrate(d_sections.reference_axis_x.data(),
+                                  d_sections.reference_axis_y.data(),
+                                  d_sections.reference_tangent_x.data(),
+                                  d_sections.reference_tangent_y.data());
+    centerManeuverAxis();
+
+    return;
+
+} // integrateManeuverAxis
+
+void
+EelKinematics::transformManeuverAxisAndCalculateTangents(const double angleFromHorizontal)
+{
+    // The tangents of the rotated axis are the rotated tangents of the reference axis.
+    const double cos_angle = cos(angleFromHorizontal);
+    const double sin_angle = sin(angleFromHorizontal);
+    const int num_sections = d_sections.size();
+    for (int i = 0; i < num_sections; ++i)
+    {
+        const double tx = d_sections.reference_tangent_x[i];
+        const double ty = d_sections.reference_tangent_y[i];
+        d_sections.transformed_tangent_x[i] = tx * cos_angle - ty * sin_angle;
+        d_sections.transformed_tangent_y[i] = tx * sin_angle + ty * cos_angle;
+    }
+
+    return;
+
+} // transformManeuverAxisAndCalculateTangents
+
+template <class BodyPolicy, class DeformationPolicy>
+void
+EelKinematics::setSectionVelocity(const int first_section,
+                                  const int last_section,
+                                  const double cos_angle,
+                                  const double sin_angle,
+                                  EvaluationContext& context)
+{
+    const BodyPolicy body(d_body_is_maneuvering);
+    const DeformationPolicy deformation(d_kinematics_type != PARSER_KINEMATICS);
+    std::array<double, DIM> vec_vel;
+    for (int section_idx = first_section; section_idx < last_section; ++section_idx)
+    {
+        double* const posn = context.variables.posn.data();
+        double* const normal = context.variables.normal.data();
+        posn[0] = d_sections.s[section_idx];
+        body.getNormal(d_sections, section_idx, cos_angle, sin_angle, normal[0], normal[1]);
+
+        if (deformation.isTabulated())
+        {
+            vec_vel[0] = d_section_deformation_rate[section_idx] * normal[0];
+            vec_vel[1] = d_section_deformation_rate[section_idx] * normal[1];
+        }
+        else
+        {
+            vec_vel[0] = evaluateFunction(DEFORMATION_VELOCITY_FUNCTION, context);
+            vec_vel[1] = evaluateFunction(DEFORMATION_VELOCITY_FUNCTION + 1, context);
+        }
+
+        const int lowerlimit = d_sections.offset[section_idx];
+        const int upperlimit = d_sections.offset[section_idx + 1];
+        for (int d = 0; d < DIM; ++d)
+        {
+            for (int i = lowerlimit; i < upperlimit; ++i) d_velocity[d][i] = vec_vel[d];
+        }
+    }
+
+    return;
+} // setSectionVelocity
+
+template <class BodyPolicy, class DeformationPolicy>
+void
+EelKinematics::setSectionShape(const int first_section, const int last_section, EvaluationContext& context)
+{
+    const BodyPolicy body(d_body_is_maneuvering);
+    const DeformationPolicy deformation(d_kinematics_type != PARSER_KINEMATICS);
+
+    // The body shape expression is evaluated in the body frame for the whole block of sections at once.
+    if (!deformation.isTabulated())
+    {
+        const double* posn[DIM] = { nullptr };
+        posn[0] = d_sections.s.data() + first_section;
+        context.variables.normal.fill(0.0);
+        evaluateFunction(BODY_SHAPE_FUNCTION,
+                         context,
+                         last_section - first_section,
+                         posn,
+                         nullptr,
+                         d_section_deformation.data() + first_section);
+    }
+
+    // The points of a section lie along its body-frame normal, on either side of the deformed backbone.
+    double* const shape_x = d_shape[0].data();
+    double* const shape_y = d_shape[1].data();
+    const double dy = d_mesh_width[1];
+    for (int section_idx = first_section; section_idx < last_section; ++section_idx)
+    {
+        const int NumPtsInSection = d_sections.num_pts[section_idx];
+        int lag_idx = d_sections.offset[section_idx] - 1;
+        const double y_shape_base = d_section_deformation[section_idx];
+        double x_base, y_base, nx, ny;
+        body.getBodyFrameSection(d_sections, section_idx, x_base, y_base, nx, ny);
+        double com_x = 0.0, com_y = 0.0;
+
+        for (int j = 1; j <= NumPtsInSection / 2; ++j)
+        {
+            const double h = y_shape_base + (j - 1) * dy;
+            shape_x[++lag_idx] = x_base + h * nx;
+            shape_y[lag_idx] = y_base + h * ny;
+            com_x += shape_x[lag_idx];
+            com_y += shape_y[lag_idx];
+        }
+
+        for (int j = 1; j <= NumPtsInSection / 2; ++j)
+        {
+            const double h = y_shape_base - j * dy;
+            shape_x[++lag_idx] = x_base + h * nx;
+            shape_y[lag_idx] = y_base + h * ny;
+            com_x += shape_x[lag_idx];
+            com_y += shape_y[lag_idx];
+        }
+
+        d_section_com_x[section_idx] = com_x;
+        d_section_com_y[section_idx] = com_y;
+    }
+
+    return;
+} // setSectionShape
+
+template <class BodyPolicy, class DeformationPolicy>
+void
+EelKinematics::setSectionKernels()
+{
+    d_section_velocity_kernel = &EelKinematics::setSectionVelocity<BodyPolicy, DeformationPolicy>;
+    d_section_shape_kernel = &EelKinematics::setSectionShape<BodyPolicy, DeformationPolicy>;
+    return;
+} // setSectionKernels
+
+void
+EelKinematics::selectSectionKernels()
+{
+    const bool is_tabulated = d_kinematics_type != PARSER_KINEMATICS;
+    if (!d_use_specialized_kernels)
+    {
+        setSectionKernels<RuntimeBodyPolicy, RuntimeDeformationPolicy>();
+    }
+    else if (d_body_is_maneuvering && is_tabulated)
+    {
+        setSectionKernels<ManeuveringBodyPolicy, TabulatedDeformationPolicy>();
+    }
+    else if (d_body_is_maneuvering)
+    {
+        setSectionKernels<ManeuveringBodyPolicy, ExpressionDeformationPolicy>();
+    }
+    else if (is_tabulated)
+    {
+        setSectionKernels<StraightBodyPolicy, TabulatedDeformationPolicy>();
+    }
+    else
+    {
+        setSectionKernels<StraightBodyPolicy, ExpressionDeformationPolicy>();
+    }
+    return;
+} // selectSectionKernels
+
+void
+EelKinematics::transformPoints(const int first_point,
+                               const int last_point,
+                               const double com_x,
+                               const double com_y,
+                               const double cos_angle,
+                               const double sin_angle)
+{
+    double* const shape_x = d_shape[0].data();
+    double* const shape_y = d_shape[1].data();
+    for (int i = first_point; i < last_point; ++i)
+    {
+        const double x_shifted = shape_x[i] - com_x;
+        const double y_shifted = shape_y[i] - com_y;
+        shape_x[i] = x_shifted * cos_angle - y_shifted * sin_angle;
+        shape_y[i] = x_shifted * sin_angle + y_shifted * cos_angle;
+    }
+
+    return;
+} // transformPoints
+
+void
+EelKinematics::computeSectionDeformation(const double time, double* y, double* dydt)
+{
+    if (d_kinematics_type == TRAVELING_WAVE_KINEMATICS)
+    {
+        d_traveling_wave.computeDeformation(time, y, dydt);
+    }
+    else
+    {
+        // The shape is evaluated in the body frame: it may depend on X_0 and T, but not on the normal. The
+        // compiled expression is reentrant, so the workers share it.
+        const int num_workers = static_cast<int>(d_contexts.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(num_workers) if (num_workers > 1)
+#endif
+        for (int k = 0; k < num_workers; ++k)
+        {
+            const int first_section = d_section_partition[k];
+            const double* posn[DIM] = { nullptr };
+            posn[0] = d_sections.s.data() + first_section;
+            KinematicsEvaluationContext& variables = d_contexts[k].variables;
+            variables.time = time;
+            variables.normal.fill(0.0);
+            d_functions[BODY_SHAPE_FUNCTION].compiled.evaluateWithTimeDerivative(variables,
+                                                                                d_section_partition[k + 1] -
+                                                                                    first_section,
+                                                                                posn,
+                                                                                nullptr,
+                                                                                y + first_section,
+                                                                                dydt + first_section);
+        }
+    }
+
+    return;
+} // computeSectionDeformation
+
+void
+EelKinematics::initializeShapeCache()
+{
+    const int num_sections = d_sections.size();
+    d_shape_cache.initialize(num_sections, d_shape_cache_num_phases, d_shape_cache_period);
+    for (int k = 0; k < d_shape_cache_num_phases; ++k)
+    {
+        computeSectionDeformation(
+            d_shape_cache.getPhaseTime(k), d_shape_cache.getShapeRow(k), d_shape_cache.getShapeRateRow(k));
+    }
+    d_shape_cache_check_deformation.resize(num_sections);
+    d_shape_cache_check_deformation_rate.resize(num_sections);
+    d_shape_cache_num_updates = 0;
+
+    // Check the accuracy midway between the tabulated phases, where the interpolation error is largest.
+    double max_error = 0.0;
+    for (int k = 0; k < d_shape_cache_num_phases; ++k)
+    {
+        const double time = 0.5 * (d_shape_cache.getPhaseTime(k) + d_shape_cache.getPhaseTime(k + 1));
+        max_error = std::max(max_error, computeShapeCacheError(time));
+    }
+    d_shape_cache_initial_error = max_error;
+    if (max_error > d_shape_cache_tolerance)
+    {
+        std::ostringstream message;
+        message << "shape cache error " << max_error << " with " << d_shape_cache_num_phases
+                << " phases exceeds shape_cache_tolerance = " << d_shape_cache_tolerance
+                << "; increase shape_cache_num_phases.";
+        throw std::runtime_error(message.str());
+    }
+
+    return;
+} // initializeShapeCache
+
+double
+EelKinematics::computeShapeCacheError(const double time)
+{
+    // Compare the shape and the velocity scaled by period/(2*pi), so that both errors are lengths.
+    computeSectionDeformation(
+        time, d_shape_cache_check_deformation.data(), d_shape_cache_check_deformation_rate.data());
+    d_shape_cache.interpolate(time, d_section_deformation.data(), d_section_deformation_rate.data());
+    const double velocity_scale = d_shape_cache_period / (2.0 * PII);
+    double max_error = 0.0;
+    const int num_sections = d_sections.size();
+    for (int i = 0; i < num_sections; ++i)
+    {
+        max_error = std::max(max_error, std::abs(d_section_deformation[i] - d_shape_cache_check_deformation[i]));
+        max_error = std::max(
+            max_error,
+            velocity_scale * std::abs(d_section_deformation_rate[i] - d_shape_cache_check_deformation_rate[i]));
+    }
+    return max_error;
+} // computeShapeCacheError
+
+} // namespace IBAMR
@@ -0,0 +1,500 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_EelKinematics
+#define included_EelKinematics
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include "CurvatureBackbone.h"
+#include "EelKinematicsPolicies.h"
+#include "EelSectionTable.h"
+#include "KinematicsExpression.h"
+#include "PeriodicShapeCache.h"
+#include "TravelingWaveKinematics.h"
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace IBAMR
+{
+/*!
+ * \brief Class EelKinematics computes the deformation velocity and the shape of the Lagrangian points of a
+ * planar eel-like body, independently of IBAMR.
+ *
+ * The body is laid out in cross sections along its backbone from the Cartesian mesh width. At each time
+ * step the kinematics are updated phase by phase:
+ *  - updateManeuverAxis() re-integrates and rotates the maneuvering axis (maneuvering bodies only),
+ *    turning the body towards the food location when the axis changes shape;
+ *  - setVelocity() sets the deformation velocity of all points;
+ *  - generateShape() builds the body-frame shape and its c.m.;
+ *  - transformShape() shifts the c.m. to the origin and rotates the shape.
+ * The section loops of these phases are split over a fixed number of workers, each with its own
+ * evaluation context, and give the same results for any number of workers. They are instantiated for each
+ * combination of the body and deformation policies (see EelKinematicsPolicies.h); the instantiation that
+ * matches the options is selected once, so the loops do not test the options section by section.
+ *
+ * Configuration errors are reported by throwing std::invalid_argument, and a shape cache that does not
+ * meet its tolerance by throwing std::runtime_error.
+ */
+class EelKinematics
+{
+public:
+    /*!
+     * Spatial dimension of the body.
+     */
+    static const int DIM = 2;
+
+    /*!
+     * User-provided kinematics functions. The deformation velocity component d is function
+     * DEFORMATION_VELOCITY_FUNCTION + d.
+     */
+    enum KinematicsFunctionIndex
+    {
+        BODY_SHAPE_FUNCTION,
+        MANEUVERING_AXIS_FUNCTION,
+        MANEUVERING_AXIS_CURVATURE_FUNCTION,
+        DEFORMATION_VELOCITY_FUNCTION,
+        NUM_FUNCTIONS = DEFORMATION_VELOCITY_FUNCTION + DIM
+    };
+
+    /*!
+     * How the deformation of the backbone is evaluated: from the user-provided expressions, from a
+     * closed-form traveling wave, or from the body shape expression alone with its time derivative obtained
+     * by automatic differentiation.
+     */
+    enum KinematicsType
+    {
+        PARSER_KINEMATICS,
+        TRAVELING_WAVE_KINEMATICS,
+        AUTODIFF_KINEMATICS
+    };
+
+    /*!
+     * Evaluator of a function that could not be compiled; it reads its variables from the evaluation context
+     * of the worker it belongs to.
+     */
+    typedef std::function<double()> FallbackFunction;
+
+    /*!
+     * \brief Constructor.
+     *
+     * \param num_workers Number of workers the section loops are split over.
+     * \param constant_names Names of the user constants that may appear in the kinematics expressions.
+     * \param constant_values Values of these constants.
+     */
+    EelKinematics(const int num_workers = 1,
+                  const std::vector<std::string>& constant_names = std::vector<std::string>(),
+                  const std::vector<double>& constant_values = std::vector<double>());
+
+    /*!
+     * \brief Set how the backbone deformation is evaluated, with the traveling wave for
+     * TRAVELING_WAVE_KINEMATICS.
+     */
+    void setKinematicsType(const KinematicsType type,
+                           const TravelingWaveKinematics& traveling_wave = TravelingWaveKinematics());
+
+    /*!
+     * \brief Set the expression of a kinematics function and compile it.
+     *
+     * \return Whether the expression was compiled; if not, a fallback evaluator must be registered for it
+     * with every worker by setFallbackFunction().
+     */
+    bool setFunction(const int function, const std::string& expression);
+
+    /*!
+     * \brief Whether the given function was compiled, its expression, and the reason it was not compiled.
+     */
+    bool isCompiled(const int function) const
+    {
+        return d_functions[function].is_compiled;
+    }
+    bool isUsed(const int function) const
+    {
+        return d_functions[function].is_used;
+    }
+    const std::string& getExpression(const int function) const
+    {
+        return d_functions[function].expression;
+    }
+    const std::string& getCompileError(const int function) const
+    {
+        return d_functions[function].compile_error;
+    }
+
+    /*!
+     * \brief Names of the user constants, in the order of the constant values of the evaluation contexts.
+     */
+    const std::vector<std::string>& getConstantNames() const
+    {
+        return d_constant_names;
+    }
+
+    /*!
+     * \brief Register the evaluator of an uncompiled function for the given worker.
+     */
+    void setFallbackFunction(const int function, const int worker, const FallbackFunction& fallback);
+
+    /*!
+     * \brief Values of the expression variables of the given worker, to which fallback evaluators bind.
+     */
+    KinematicsEvaluationContext& getEvaluationVariables(const int worker)
+    {
+        return d_contexts[worker].variables;
+    }
+
+    /*!
+     * \brief Set the maneuvering options: whether the body follows a maneuvering axis, whether that axis
+     * is given by the curvature law MANEUVERING_AXIS_CURVATURE_FUNCTION (otherwise by the axis function
+     * MANEUVERING_AXIS_FUNCTION), and whether it changes shape to track the food location.
+     */
+    void setManeuvering(const bool body_is_maneuvering,
+                        const bool axis_has_curvature_law,
+                        const bool axis_is_changing_shape);
+
+    /*!
+     * \brief Set the food location tracked by a maneuvering axis that changes shape.
+     */
+    void setFoodLocation(const double* food_location);
+
+    /*!
+     * \brief Set and get the initial angle of the body axis with the x-axis.
+     */
+    void setInitialAngle(const double angle)
+    {
+        d_initial_angle = angle;
+    }
+    double getInitialAngle() const
+    {
+        return d_initial_angle;
+    }
+
+    /*!
+     * \brief Enable the cache of the periodic deformation, for TRAVELING_WAVE or AUTODIFF kinematics.
+     */
+    void setShapeCache(const int num_phases, const double period, const double tolerance, const int check_interval);
+
+    /*!
+     * \brief Whether the section loops use the kernels specialized for the maneuvering and kinematics type
+     * options (the default), or generic kernels that test these options at every section. The generic kernels
+     * give the same results and are kept as a reference for benchmarking the specialized ones.
+     */
+    void setUseSpecializedKernels(const bool use_specialized_kernels);
+
+    /*!
+     * \brief Lay out the body in cross sections for the given mesh width, allocate all per-section and
+     * per-point data, and evaluate the maneuvering axis at the given time.
+     *
+     * \return The number of Lagrangian points of the body.
+     */
+    int setBodyLayout(const double* mesh_width, const double time);
+
+    /*!
+     * \brief Update the maneuvering axis for the given rotation of the body, its c.m. and the position of
+     * its tagged point (head). Does nothing for a body that is not maneuvering.
+     */
+    void updateManeuverAxis(const double time,
+                            const double incremented_angle,
+                            const double* center_of_mass,
+                            const double* tagged_pt_position);
+
+    /*!
+     * \brief Set the deformation velocity of all points for the given rotation of the body.
+     */
+    void setVelocity(const double time, const double incremented_angle);
+
+    /*!
+     * \brief Generate the body-frame shape of all points and its c.m.
+     */
+    void generateShape(const double time);
+
+    /*!
+     * \brief Shift the c.m. of the shape to the origin and rotate the shape by the given angle.
+     */
+    void transformShape(const double incremented_angle);
+
+    /*!
+     * \brief Evaluate the backbone deformation and its time derivative at all sections for the non-parser
+     * kinematics types, unless they have already been evaluated at this time.
+     */
+    void updateSectionDeformation(const double time);
+
+    /*!
+     * \brief Whether a runtime check of the shape cache exceeded the tolerance since the last call; if so,
+     * the error and the time of that check are returned.
+     */
+    bool checkShapeCacheFailed(double& error, double& time);
+
+    /*!
+     * \brief Maximum interpolation error of the shape cache found when it was tabulated.
+     */
+    double getShapeCacheError() const
+    {
+        return d_shape_cache_initial_error;
+    }
+
+    /*!
+     * \brief Deformation velocity and shape of the points, indexed [component][point].
+     */
+    const std::vector<std::vector<double> >& getVelocity() const
+    {
+        return d_velocity;
+    }
+    const std::vector<std::vector<double> >& getShape() const
+    {
+        return d_shape;
+    }
+
+    /*!
+     * \brief Cross sections of the body.
+     */
+    const EelSectionTable& getSections() const
+    {
+        return d_sections;
+    }
+
+    /*!
+     * \brief Mesh width the body was laid out for.
+     */
+    const double* getMeshWidth() const
+    {
+        return d_mesh_width.data();
+    }
+
+    /*!
+     * \brief Options.
+     */
+    KinematicsType getKinematicsType() const
+    {
+        return d_kinematics_type;
+    }
+    bool bodyIsManeuvering() const
+    {
+        return d_body_is_maneuvering;
+    }
+    int getNumberOfWorkers() const
+    {
+        return static_cast<int>(d_contexts.size());
+    }
+    double getShapeCachePeriod() const
+    {
+        return d_shape_cache_period;
+    }
+
+private:
+    /*!
+     * A kinematics function, compiled once and shared by all evaluation contexts.
+     */
+    struct KinematicsFunction
+    {
+        KinematicsFunction() : is_used(false), is_compiled(false)
+        {
+        }
+
+        std::string expression, compile_error;
+        KinematicsExpression compiled;
+        bool is_used, is_compiled;
+    };
+
+    /*!
+     * Evaluation context of one worker of the section loops: the values of the expression variables and the
+     * fallback evaluators of the functions that could not be compiled.
+     */
+    struct EvaluationContext
+    {
+        KinematicsEvaluationContext variables;
+        std::array<FallbackFunction, NUM_FUNCTIONS> fallbacks;
+    };
+
+    /*!
+     * \brief Evaluate a kinematics function at the position, normal and time held by the context.
+     */
+    double evaluateFunction(const int function, EvaluationContext& context) const;
+
+    /*!
+     * \brief Evaluate a kinematics function at num_points points; posn[d] and normal[d] are arrays of the
+     * coordinates of the points (nullptr for components held constant by the context).
+     */
+    void evaluateFunction(const int function,
+                          EvaluationContext& context,
+                          const int num_points,
+                          const double* const* posn,
+                          const double* const* normal,
+                          double* values) const;
+
+    /*!
+     * \brief Split the sections into contiguous blocks of roughly equal numbers of points, one per worker.
+     */
+    void partitionSections();
+
+    /*!
+     * \brief Center the reference maneuver axis at the origin and calculate its tangents.
+     */
+    void centerManeuverAxisAndCalculateTangents();
+
+    /*!
+     * \brief Shift the reference maneuver axis so that its COM is at the origin.
+     */
+    void centerManeuverAxis();
+
+    /*!
+     * \brief Integrate the reference maneuver axis and its tangents from its curvature, and shift its COM to
+     * the origin. With a curvature law the curvature is first evaluated at the given time; otherwise the
+     * curvature already set in d_maneuver_backbone is used.
+     */
+    void integrateManeuverAxis(const double time);
+
+    /*!
+     * \brief Rotate the tangents of the reference maneuver axis by the given angle.
+     */
+    void transformManeuverAxisAndCalculateTangents(const double angleFromHorizontal);
+
+    /*!
+     * \brief Set the deformation velocity of the points of sections [first_section, last_section).
+     */
+    template <class BodyPolicy, class DeformationPolicy>
+    void setSectionVelocity(const int first_section,
+                            const int last_section,
+                            const double cos_angle,
+                            const double sin_angle,
+                            EvaluationContext& context);
+
+    /*!
+     * \brief Generate the body-frame shape of sections [first_section, last_section) and the sums of its
+     * coordinates over each section.
+     */
+    template <class BodyPolicy, class DeformationPolicy>
+    void setSectionShape(const int first_section, const int last_section, EvaluationContext& context);
+
+    /*!
+     * \brief Select the instantiations of the section loops for the current options.
+     */
+    void selectSectionKernels();
+
+    /*!
+     * \brief Instantiations of the section loops for the given policies.
+     */
+    template <class BodyPolicy, class DeformationPolicy>
+    void setSectionKernels();
+
+    /*!
+     * \brief Shift the c.m. of points [first_point, last_point) of the shape to the origin and rotate them.
+     */
+    void transformPoints(const int first_point,
+                         const int last_point,
+                         const double com_x,
+                         const double com_y,
+                         const double cos_angle,
+                         const double sin_angle);
+
+    /*!
+     * \brief Evaluate the backbone deformation and its time derivative at all sections directly, bypassing the
+     * shape cache.
+     */
+    void computeSectionDeformation(const double time, double* y, double* dydt);
+
+    /*!
+     * \brief Tabulate the deformation over one period and check the interpolation accuracy.
+     */
+    void initializeShapeCache();
+
+    /*!
+     * \brief Maximum difference between the cached and the directly evaluated deformation at the given time.
+     */
+    double computeShapeCacheError(const double time);
+
+    /*!
+     * Kinematics functions, names of the user constants that may appear in them, and one evaluation context
+     * per worker. The maneuvering axis is only evaluated serially, in the first context.
+     */
+    std::array<KinematicsFunction, NUM_FUNCTIONS> d_functions;
+    std::vector<std::string> d_constant_names;
+    std::vector<EvaluationContext> d_contexts;
+
+    /*!
+     * Instantiations of the section loops in use.
+     */
+    typedef void (EelKinematics::*SectionVelocityKernel)(const int, const int, const double, const double,
+                                                          EvaluationContext&);
+    typedef void (EelKinematics::*SectionShapeKernel)(const int, const int, EvaluationContext&);
+    bool d_use_specialized_kernels;
+    SectionVelocityKernel d_section_velocity_kernel;
+    SectionShapeKernel d_section_shape_kernel;
+
+    /*!
+     * Worker k handles the sections [d_section_partition[k], d_section_partition[k+1]), which hold roughly
+     * equal numbers of Lagrangian points.
+     */
+    std::vector<int> d_section_partition;
+
+    /*!
+     * Sums of the body-frame shape coordinates over the points of each section, added up in section order
+     * for the c.m. so that it does not depend on the number of workers, and the c.m. itself.
+     */
+    std::vector<double> d_section_com_x, d_section_com_y;
+    double d_shape_com_x, d_shape_com_y;
+
+    /*!
+     * Deformation velocity and shape of the body, and the mesh width it is laid out for.
+     */
+    std::vector<std::vector<double> > d_velocity, d_shape;
+    std::array<double, DIM> d_mesh_width;
+
+    /*!
+     * Closed-form traveling wave, and the per-section values y and dy/dt at d_deformation_time.
+     */
+    KinematicsType d_kinematics_type;
+    TravelingWaveKinematics d_traveling_wave;
+    std::vector<double> d_section_deformation, d_section_deformation_rate;
+    double d_deformation_time;
+
+    /*!
+     * Optional cache of the periodic deformation at d_shape_cache_num_phases phases per period, with its
+     * accuracy tolerance, the interval (in updates) between runtime checks, scratch storage for them, and
+     * the outcome of the checks.
+     */
+    bool d_use_shape_cache;
+    int d_shape_cache_num_phases, d_shape_cache_check_interval, d_shape_cache_num_updates;
+    double d_shape_cache_period, d_shape_cache_tolerance;
+    PeriodicShapeCache d_shape_cache;
+    std::vector<double> d_shape_cache_check_deformation, d_shape_cache_check_deformation_rate;
+    double d_shape_cache_initial_error;
+    bool d_shape_cache_check_failed;
+    double d_shape_cache_check_error, d_shape_cache_check_time;
+
+    /*!
+     * Body kinematics flags, the initial angle of the body axis and the food location.
+     */
+    bool d_body_is_maneuvering, d_maneuver_axis_has_curvature_law, d_maneuver_axis_is_changing_shape;
+    double d_initial_angle;
+    std::array<double, DIM> d_food_location;
+
+    /*!
+     * Arc-length parametrized maneuvering axis integrated from its curvature (also used for the circular
+     * arcs of food tracking).
+     */
+    CurvatureBackbone d_maneuver_backbone;
+
+    /*!
+     * Immersed body data: arc length, number of points, Lagrangian offset and maneuvering axis tangents of
+     * each section, built once in setBodyLayout().
+     */
+    EelSectionTable d_sections;
+
+}; // EelKinematics
+
+} // namespace IBAMR
+
+#endif // #ifndef included_EelKinematics
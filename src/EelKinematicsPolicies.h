@@ -0,0 +1,190 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_EelKinematicsPolicies
+#define included_EelKinematicsPolicies
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include "EelSectionTable.h"
+
+namespace IBAMR
+{
+/*!
+ * \brief Body policies of the EelKinematics section loops: where a section lies in the body frame and
+ * which way its normal points.
+ *
+ * A policy is constructed once per block of sections from the runtime maneuvering flag. The straight and
+ * maneuvering policies ignore the flag, so their functions reduce to a few loads and the section loops
+ * they are instantiated in have no branches; the runtime policy tests the flag at every section.
+ */
+struct StraightBodyPolicy
+{
+    explicit StraightBodyPolicy(const bool /*body_is_maneuvering*/)
+    {
+    }
+
+    /*!
+     * \brief Unit normal of section i in the lab frame, for the given rotation of the body.
+     */
+    void getNormal(const EelSectionTable& /*sections*/,
+                   const int /*i*/,
+                   const double cos_angle,
+                   const double sin_angle,
+                   double& nx,
+                   double& ny) const
+    {
+        nx = -sin_angle;
+        ny = cos_angle;
+    }
+
+    /*!
+     * \brief Backbone point and unit normal of section i in the body frame.
+     */
+    void getBodyFrameSection(const EelSectionTable& sections,
+                             const int i,
+                             double& x,
+                             double& y,
+                             double& nx,
+                             double& ny) const
+    {
+        x = sections.s[i];
+        y = 0.0;
+        nx = 0.0;
+        ny = 1.0;
+    }
+};
+
+struct ManeuveringBodyPolicy
+{
+    explicit ManeuveringBodyPolicy(const bool /*body_is_maneuvering*/)
+    {
+    }
+
+    void getNormal(const EelSectionTable& sections,
+                   const int i,
+                   const double /*cos_angle*/,
+                   const double /*sin_angle*/,
+                   double& nx,
+                   double& ny) const
+    {
+        nx = -sections.transformed_tangent_y[i];
+        ny = sections.transformed_tangent_x[i];
+    }
+
+    void getBodyFrameSection(const EelSectionTable& sections,
+                             const int i,
+                             double& x,
+                             double& y,
+                             double& nx,
+                             double& ny) const
+    {
+        x = sections.reference_axis_x[i];
+        y = sections.reference_axis_y[i];
+        nx = -sections.reference_tangent_y[i];
+        ny = sections.reference_tangent_x[i];
+    }
+};
+
+struct RuntimeBodyPolicy
+{
+    explicit RuntimeBodyPolicy(const bool body_is_maneuvering) : is_maneuvering(body_is_maneuvering)
+    {
+    }
+
+    void getNormal(const EelSectionTable& sections,
+                   const int i,
+                   const double cos_angle,
+                   const double sin_angle,
+                   double& nx,
+                   double& ny) const
+    {
+        if (is_maneuvering)
+        {
+            ManeuveringBodyPolicy(true).getNormal(sections, i, cos_angle, sin_angle, nx, ny);
+        }
+        else
+        {
+            StraightBodyPolicy(false).getNormal(sections, i, cos_angle, sin_angle, nx, ny);
+        }
+    }
+
+    void getBodyFrameSection(const EelSectionTable& sections,
+                             const int i,
+                             double& x,
+                             double& y,
+                             double& nx,
+                             double& ny) const
+    {
+        if (is_maneuvering)
+        {
+            ManeuveringBodyPolicy(true).getBodyFrameSection(sections, i, x, y, nx, ny);
+        }
+        else
+        {
+            StraightBodyPolicy(false).getBodyFrameSection(sections, i, x, y, nx, ny);
+        }
+    }
+
+    const bool is_maneuvering;
+};
+
+/*!
+ * \brief Deformation policies of the EelKinematics section loops: whether the backbone deformation and its
+ * rate are tabulated per section before the loops (TRAVELING_WAVE and AUTODIFF kinematics), or given by the
+ * body shape and deformation velocity expressions (PARSER kinematics).
+ *
+ * As for the body policies, the tabulated and expression policies answer with a constant and the runtime
+ * policy with the runtime flag.
+ */
+struct TabulatedDeformationPolicy
+{
+    explicit TabulatedDeformationPolicy(const bool /*deformation_is_tabulated*/)
+    {
+    }
+
+    bool isTabulated() const
+    {
+        return true;
+    }
+};
+
+struct ExpressionDeformationPolicy
+{
+    explicit ExpressionDeformationPolicy(const bool /*deformation_is_tabulated*/)
+    {
+    }
+
+    bool isTabulated() const
+    {
+        return false;
+    }
+};
+
+struct RuntimeDeformationPolicy
+{
+    explicit RuntimeDeformationPolicy(const bool deformation_is_tabulated) : is_tabulated(deformation_is_tabulated)
+    {
+    }
+
+    bool isTabulated() const
+    {
+        return is_tabulated;
+    }
+
+    const bool is_tabulated;
+};
+
+} // namespace IBAMR
+
+#endif // #ifndef included_EelKinematicsPolicies
@@ -0,0 +1,102 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_EelSectionTable
+#define included_EelSectionTable
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include <vector>
+
+namespace IBAMR
+{
+/*!
+ * \brief Struct EelSectionTable is a flat, index-addressed description of the cross sections of the
+ * body along its backbone.
+ *
+ * Section i sits at arc length s[i] and owns the num_pts[i] Lagrangian points with indices
+ * [offset[i], offset[i+1]). All per-section data are stored as separate contiguous arrays so that
+ * the section loops stream through memory without any lookups.
+ *
+ * The unit tangents of the maneuvering axis are stored in the reference frame and in the rotated
+ * (transformed) frame; the corresponding unit normal is the tangent rotated by +90 degrees, i.e.
+ * (-t_y, t_x).
+ */
+struct EelSectionTable
+{
+    /*!
+     * \brief Allocate storage for the given number of sections.
+     */
+    void resize(const int num_sections)
+    {
+        s.resize(num_sections);
+        num_pts.resize(num_sections);
+        offset.resize(num_sections + 1);
+        reference_axis_x.resize(num_sections);
+        reference_axis_y.resize(num_sections);
+        reference_tangent_x.resize(num_sections);
+        reference_tangent_y.resize(num_sections);
+        transformed_tangent_x.resize(num_sections);
+        transformed_tangent_y.resize(num_sections);
+        return;
+    } // resize
+
+    /*!
+     * \brief Fill the prefix offsets from the point counts.
+     */
+    void computeOffsets()
+    {
+        offset[0] = 0;
+        for (int i = 0; i < size(); ++i) offset[i + 1] = offset[i] + num_pts[i];
+        return;
+    } // computeOffsets
+
+    /*!
+     * \brief Number of sections.
+     */
+    int size() const
+    {
+        return static_cast<int>(s.size());
+    } // size
+
+    /*!
+     * \brief Total number of Lagrangian points in all sections.
+     */
+    int getNumberOfPoints() const
+    {
+        return offset.empty() ? 0 : offset.back();
+    } // getNumberOfPoints
+
+    /*!
+     * Arc length, number of points and prefix offset into the Lagrangian index of each section.
+     */
+    std::vector<double> s;
+    std::vector<int> num_pts;
+    std::vector<int> offset;
+
+    /*!
+     * Maneuvering axis coordinates in the reference frame, shifted so that their centroid is the origin.
+     */
+    std::vector<double> reference_axis_x, reference_axis_y;
+
+    /*!
+     * Unit tangents to the maneuvering axis in the reference and in the transformed frame.
+     */
+    std::vector<double> reference_tangent_x, reference_tangent_y;
+    std::vector<double> transformed_tangent_x, transformed_tangent_y;
+
+}; // EelSectionTable
+
+} // namespace IBAMR
+
+#endif // #ifndef included_EelSectionTable
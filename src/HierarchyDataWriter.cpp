@@ -0,0 +1,167 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+//////////////////////////// INCLUDES /////////////////////////////////////////
+#include "ibtk/IBTK_MPI.h"
+
+#include "HierarchyDataWriter.h"
+#include "tbox/Utilities.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "ibamr/namespaces.h"
+
+namespace IBAMR
+{
+namespace
+{
+static const char FILE_MAGIC[8] = { 'E', 'E', 'L', '2', 'D', 'H', 'I', 'E' };
+static const int FILE_VERSION = 1;
+static const int HEADER_SIZE = 64;
+static const int NAME_SIZE = 64;
+static const int VARIABLE_SIZE = NAME_SIZE + 8;
+static const int RECORD_SIZE = 32 + 24 * NDIM;
+
+} // namespace
+
+HierarchyDataWriter::HierarchyDataWriter(const std::string& object_name,
+                                         const std::string& dirname,
+                                         const int num_writers)
+    : d_object_name(object_name),
+      d_dirname(dirname),
+      d_num_writers(num_writers),
+      d_snapshot(object_name + "::PatchDataSnapshot")
+{
+    return;
+} // HierarchyDataWriter
+
+void
+HierarchyDataWriter::registerPatchData(const std::string& name, const int patch_data_idx)
+{
+    if (static_cast<int>(name.size()) >= NAME_SIZE)
+    {
+        TBOX_ERROR(d_object_name << "::registerPatchData() :\n"
+                                 << "  variable name " << name << " is longer than " << NAME_SIZE - 1
+                                 << " characters" << std::endl);
+    }
+    d_snapshot.registerPatchData(name, patch_data_idx);
+    return;
+} // registerPatchData
+
+void
+HierarchyDataWriter::writeData(Pointer<PatchHierarchy<NDIM> > hierarchy,
+                               const int time_step_number,
+                               const double simulation_time)
+{
+    MPI_Comm comm = IBTK_MPI::getCommunicator();
+    const int rank = IBTK_MPI::getRank();
+    d_snapshot.copyPatchData(hierarchy);
+    const std::vector<PatchDataSnapshot::Variable>& variables = d_snapshot.getVariables();
+    const std::vector<PatchDataSnapshot::PatchRecord>& patches = d_snapshot.getPatches();
+    const std::vector<double>& values = d_snapshot.getValues();
+
+    // Position of the local patch records and values among those of all ranks, in rank order.
+    long long local_counts[2] = { static_cast<long long>(patches.size()), static_cast<long long>(values.size()) };
+    long long starts[2] = { 0, 0 }, totals[2];
+    MPI_Exscan(local_counts, starts, 2, MPI_LONG_LONG, MPI_SUM, comm);
+    if (rank == 0) starts[0] = starts[1] = 0;
+    MPI_Allreduce(local_counts, totals, 2, MPI_LONG_LONG, MPI_SUM, comm);
+    const long long index_offset = HEADER_SIZE + VARIABLE_SIZE * static_cast<long long>(variables.size());
+    const long long data_offset = index_offset + RECORD_SIZE * totals[0];
+    const long long local_data_offset = data_offset + static_cast<long long>(sizeof(double)) * starts[1];
+
+    // Local part of the patch index.
+    d_index.resize(RECORD_SIZE * patches.size());
+    for (std::size_t k = 0; k < patches.size(); ++k)
+    {
+        const PatchDataSnapshot::PatchRecord& patch = patches[k];
+        const int ints[4] = { patch.level_number, patch.variable, rank, 0 };
+        const long long extent[2] = { local_data_offset + static_cast<long long>(sizeof(double) * patch.offset),
+                                      static_cast<long long>(patch.num_values) };
+        char* record = d_index.data() + RECORD_SIZE * k;
+        std::memcpy(record, ints, 16);
+        std::memcpy(record + 16, patch.lower, 4 * NDIM);
+        std::memcpy(record + 16 + 4 * NDIM, patch.upper, 4 * NDIM);
+        std::memcpy(record + 16 + 8 * NDIM, patch.x_lower, 8 * NDIM);
+        std::memcpy(record + 16 + 16 * NDIM, patch.dx, 8 * NDIM);
+        std::memcpy(record + 16 + 24 * NDIM, extent, 16);
+    }
+
+    // Open the shared file, with aggregation onto the requested number of writer ranks.
+    char temp_buf[128];
+    std::sprintf(temp_buf, "/hier_data.%05d.bin", time_step_number);
+    const std::string file_name = d_dirname + temp_buf;
+    MPI_Info info = MPI_INFO_NULL;
+    if (d_num_writers > 0)
+    {
+        MPI_Info_create(&info);
+        std::sprintf(temp_buf, "%d", d_num_writers);
+        MPI_Info_set(info, const_cast<char*>("cb_nodes"), temp_buf);
+        MPI_Info_set(info, const_cast<char*>("romio_cb_write"), const_cast<char*>("enable"));
+    }
+    MPI_File fh;
+    const int open_status =
+        MPI_File_open(comm, const_cast<char*>(file_name.c_str()), MPI_MODE_CREATE | MPI_MODE_WRONLY, info, &fh);
+    if (info != MPI_INFO_NULL) MPI_Info_free(&info);
+    if (open_status != MPI_SUCCESS)
+    {
+        TBOX_ERROR(d_object_name << "::writeData() :\n"
+                                 << "  could not open " << file_name << std::endl);
+    }
+    MPI_File_set_size(fh, 0);
+
+    // Header and variables.
+    if (rank == 0)
+    {
+        std::vector<char> header(index_offset, 0);
+        const int header_ints[4] = { FILE_VERSION, NDIM, time_step_number, static_cast<int>(variables.size()) };
+        const long long header_offsets[2] = { index_offset, data_offset };
+        std::memcpy(header.data(), FILE_MAGIC, 8);
+        std::memcpy(header.data() + 8, header_ints, 16);
+        std::memcpy(header.data() + 24, &totals[0], 8);
+        std::memcpy(header.data() + 32, &simulation_time, 8);
+        std::memcpy(header.data() + 40, header_offsets, 16);
+        for (std::size_t var = 0; var < variables.size(); ++var)
+        {
+            char* entry = header.data() + HEADER_SIZE + VARIABLE_SIZE * var;
+            const int ints[2] = { variables[var].centering, variables[var].depth };
+            std::memcpy(entry, variables[var].name.data(), variables[var].name.size());
+            std::memcpy(entry + NAME_SIZE, ints, 8);
+        }
+        MPI_File_write_at(fh, 0, header.data(), static_cast<int>(header.size()), MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+
+    // Every rank writes its index records and values at their offsets.
+    const int index_status = MPI_File_write_at_all(fh,
+                                                   index_offset + RECORD_SIZE * starts[0],
+                                                   d_index.data(),
+                                                   static_cast<int>(d_index.size()),
+                                                   MPI_BYTE,
+                                                   MPI_STATUS_IGNORE);
+    const int data_status = MPI_File_write_at_all(fh,
+                                                  local_data_offset,
+                                                  const_cast<double*>(values.data()),
+                                                  static_cast<int>(values.size()),
+                                                  MPI_DOUBLE,
+                                                  MPI_STATUS_IGNORE);
+    MPI_File_close(&fh);
+    if (index_status != MPI_SUCCESS || data_status != MPI_SUCCESS)
+    {
+        TBOX_ERROR(d_object_name << "::writeData() :\n"
+                                 << "  could not write " << file_name << std::endl);
+    }
+    return;
+} // writeData
+
+} // namespace IBAMR
@@ -0,0 +1,99 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_HierarchyDataWriter
+#define included_HierarchyDataWriter
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include "PatchDataSnapshot.h"
+
+#include <PatchHierarchy.h>
+#include <tbox/Pointer.h>
+
+#include <string>
+#include <vector>
+
+namespace IBAMR
+{
+/*!
+ * \brief Class HierarchyDataWriter writes the patch data of all ranks for a post-processing dump into a single
+ * shared file with collective MPI-IO, instead of one SAMRAI HDF5 file per rank.
+ *
+ * The collective writes let the MPI-IO layer aggregate the data of all ranks onto num_writers writer ranks
+ * (the cb_nodes hint; 0 keeps the default of the MPI implementation) before they reach the file system. The
+ * file dirname/hier_data.NNNNN.bin (NNNNN the time step number) has, in the native byte order:
+ *
+ * - a 64 byte header: the 8 characters EEL2DHIE, int32 version, dimension, time step number and number of
+ *   variables, int64 number of patch records, float64 time, int64 offsets of the patch index and of the data,
+ *   and 8 reserved bytes;
+ * - for each variable, 72 bytes: the name padded with zeros to 64 characters, int32 centering (0 cell, 1 side)
+ *   and int32 depth;
+ * - the patch index, one record of 32 + 24 NDIM bytes per variable and patch: int32 level number, variable
+ *   number, owner rank and a reserved int32, int32 lower and upper cell index of the patch box, float64 lower
+ *   corner and mesh width of the patch, int64 offset of its values in the file and number of values;
+ * - the values of the patches, laid out as in PatchDataSnapshot.
+ *
+ * A reader loads the header and the index, and then only the values of the patches that overlap the region of
+ * interest; scripts/read_hierarchy_data.py does this.
+ */
+class HierarchyDataWriter
+{
+public:
+    /*!
+     * \brief Constructor.
+     */
+    HierarchyDataWriter(const std::string& object_name, const std::string& dirname, const int num_writers);
+
+    /*!
+     * \brief Register cell or side centered double precision patch data to be written under the given name.
+     */
+    void registerPatchData(const std::string& name, const int patch_data_idx);
+
+    /*!
+     * \brief Write the registered patch data of the hierarchy; collective.
+     */
+    void writeData(SAMRAI::tbox::Pointer<SAMRAI::hier::PatchHierarchy<NDIM> > hierarchy,
+                   const int time_step_number,
+                   const double simulation_time);
+
+private:
+    /*!
+     * \brief Default constructor (not implemented).
+     */
+    HierarchyDataWriter();
+
+    /*!
+     * \brief Copy constructor (not implemented).
+     */
+    HierarchyDataWriter(const HierarchyDataWriter& from);
+
+    /*!
+     * \brief Assignment operator (not implemented).
+     */
+    HierarchyDataWriter& operator=(const HierarchyDataWriter& that);
+
+    std::string d_object_name, d_dirname;
+    int d_num_writers;
+
+    /*!
+     * The local patch data and the local part of the patch index.
+     */
+    PatchDataSnapshot d_snapshot;
+    std::vector<char> d_index;
+
+}; // HierarchyDataWriter
+
+} // namespace IBAMR
+
+#endif // #ifndef included_HierarchyDataWriter
@@ -13,46 +13,60 @@
 
 //////////////////////////// INCLUDES /////////////////////////////////////////
 #include "ibtk/IBTK_MPI.h"
+#include "ibtk/LData.h"
+#include "ibtk/LMesh.h"
+#include "ibtk/LNode.h"
 
+#include "AllocationCounter.h"
 #include "CartesianPatchGeometry.h"
 #include "IBEELKinematics.h"
 #include "PatchLevel.h"
-#include "tbox/MathUtilities.h"
+#include "tbox/TimerManager.h"
 
 #include "muParser.h"
 
+#include <stdexcept>
+
 #include <cmath>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
+#include "ibamr/ibamr_utilities.h"
 #include "ibamr/namespaces.h"
 
 namespace IBAMR
 {
 namespace
 {
-inline int
-sign(const double X)
-{
-    return ((X > 0) ? 1 : ((X < 0) ? -1 : 0));
-}
-
 static const double PII = 3.1415926535897932384626433832795;
-static const double __INFINITY = 1e9;
 
-// Set Fish Related Parameters.
+// Length of the fish, which is also the default length of the traveling wave envelope.
 static const double LENGTH_FISH = 1.0;
-static const double WIDTH_HEAD = 0.04 * LENGTH_FISH;
-static const double LENGTH_HEAD = 0.04;
 
-// prey capturing parameters.
-static const double CUT_OFF_ANGLE = PII / 4;
-static const double CUT_OFF_RADIUS = 0.7;
-static const double LOWER_CUT_OFF_ANGLE = 7 * PII / 180;
+// Timers.
+static Timer* t_set_kinematics_velocity;
+static Timer* t_calculate_adaptive_kinematics;
+static Timer* t_update_maneuver_axis;
+static Timer* t_set_section_velocity;
+static Timer* t_set_shape;
+static Timer* t_set_section_shape;
+static Timer* t_transform_shape;
+static Timer* t_update_school_deformation;
+static Timer* t_update_performance_metrics;
 
 } // namespace
 
+// The kinematics core is planar.
+static_assert(NDIM == EelKinematics::DIM, "IBEELKinematics requires NDIM == 2");
+
 ///////////////////////////////////////////////////////////////////////
 
 IBEELKinematics::IBEELKinematics(const std::string& object_name,
@@ -61,19 +75,32 @@ IBEELKinematics::IBEELKinematics(const std::string& object_name,
                                  Pointer<PatchHierarchy<NDIM> > patch_hierarchy,
                                  bool register_for_restart)
     : ConstraintIBKinematics(object_name, input_db, l_data_manager, register_for_restart),
+      d_l_data_manager(l_data_manager),
       d_current_time(0.0),
-      d_kinematics_vel(NDIM),
-      d_shape(NDIM),
       d_center_of_mass(3),
       d_incremented_angle_from_reference_axis(3),
-      d_tagged_pt_position(3),
-      d_mesh_width(NDIM),
-      d_parser_time(0.0)
+      d_tagged_pt_position(3)
 {
+    // Setup timers.
+    IBAMR_DO_ONCE(
+        t_set_kinematics_velocity =
+            TimerManager::getManager()->getTimer("IBAMR::IBEELKinematics::setKinematicsVelocity()");
+        t_calculate_adaptive_kinematics =
+            TimerManager::getManager()->getTimer("IBAMR::IBEELKinematics::calculateAdaptiveKinematics()");
+        t_update_maneuver_axis = TimerManager::getManager()->getTimer("IBAMR::IBEELKinematics::updateManeuverAxis()");
+        t_set_section_velocity = TimerManager::getManager()->getTimer("IBAMR::IBEELKinematics::setSectionVelocity()");
+        t_set_shape = TimerManager::getManager()->getTimer("IBAMR::IBEELKinematics::setShape()");
+        t_set_section_shape = TimerManager::getManager()->getTimer("IBAMR::IBEELKinematics::setSectionShape()");
+        t_transform_shape = TimerManager::getManager()->getTimer("IBAMR::IBEELKinematics::transformShape()");
+        t_update_school_deformation =
+            TimerManager::getManager()->getTimer("IBAMR::IBEELKinematics::updateSchoolDeformation()");
+        t_update_performance_metrics =
+            TimerManager::getManager()->getTimer("IBAMR::IBEELKinematics::updatePerformanceMetrics()"););
+
     // Read from inputdb
-    d_initAngle_bodyAxis_x = input_db->getDoubleWithDefault("initial_angle_body_axis_0", 0.0);
-    d_bodyIsManeuvering = input_db->getBoolWithDefault("body_is_maneuvering", false);
-    d_maneuverAxisIsChangingShape = input_db->getBoolWithDefault("maneuvering_axis_is_changing_shape", false);
+    const double initAngle_bodyAxis_x = input_db->getDoubleWithDefault("initial_angle_body_axis_0", 0.0);
+    const bool bodyIsManeuvering = input_db->getBoolWithDefault("body_is_maneuvering", false);
+    const bool maneuverAxisIsChangingShape = input_db->getBoolWithDefault("maneuvering_axis_is_changing_shape", false);
 
     // Read Reynolds number and thickness parameters
     d_reynolds_number = input_db->getDoubleWithDefault("reynolds_number", 5609.0);
@@ -91,89 +118,221 @@ IBEELKinematics::IBEELKinematics(const std::string& object_name,
     // Performance tracking
     d_track_performance = input_db->getBoolWithDefault("track_performance", true);
     d_performance_log_file = input_db->getStringWithDefault("performance_log_file", "performance_metrics.dat");
+    d_performance_flush_rows = input_db->getIntegerWithDefault("performance_flush_rows", 64);
+    d_performance_flush_interval = input_db->getDoubleWithDefault("performance_flush_interval", 5.0);
+    if (d_performance_flush_interval <= 0.0)
+    {
+        TBOX_ERROR("IBEELKinematics::IBEELKinematics() :\n"
+                   << "  performance_flush_interval = " << d_performance_flush_interval
+                   << " must be positive." << std::endl);
+    }
+    std::string cycle_statistics_file = d_performance_log_file;
+    const std::string::size_type extension = cycle_statistics_file.rfind(".dat");
+    if (extension != std::string::npos && extension + 4 == cycle_statistics_file.size())
+    {
+        cycle_statistics_file.erase(extension);
+    }
+    d_cycle_statistics_file =
+        input_db->getStringWithDefault("cycle_statistics_file", cycle_statistics_file + "_cycles.dat");
     d_instantaneous_thrust = 0.0;
     d_instantaneous_power = 0.0;
+    d_instantaneous_efficiency = 0.0;
     d_swimming_speed = 0.0;
+    d_last_performance_write_time = -1.0;
+    d_last_adaptation_log_time = -1.0;
 
     // Initialize adapted parameters (will be updated in calculateAdaptiveKinematics)
     d_adapted_amplitude = d_base_amplitude;
     d_adapted_frequency = d_base_frequency;
     d_adapted_wavelength = 1.0;
 
-    // Read-in deformation velocity functions
-    std::vector<std::string> deformationvel_function_strings;
-    for (int d = 0; d < NDIM; ++d)
+    // Read how the backbone deformation is to be evaluated.
+    EelKinematics::KinematicsType type = EelKinematics::PARSER_KINEMATICS;
+    const std::string kinematics_type = input_db->getStringWithDefault("kinematics_type", "PARSER");
+    if (kinematics_type == "PARSER")
+    {
+        type = EelKinematics::PARSER_KINEMATICS;
+    }
+    else if (kinematics_type == "TRAVELING_WAVE")
+    {
+        type = EelKinematics::TRAVELING_WAVE_KINEMATICS;
+    }
+    else if (kinematics_type == "AUTODIFF")
+    {
+        type = EelKinematics::AUTODIFF_KINEMATICS;
+    }
+    else
+    {
+        TBOX_ERROR("IBEELKinematics::IBEELKinematics() :\n"
+                   << "  unknown kinematics_type ``" << kinematics_type << " ''; "
+                   << "valid choices are PARSER, TRAVELING_WAVE and AUTODIFF." << std::endl);
+    }
+
+    // The closed-form traveling wave y = A*((X_0 + c0)/c1)^p * sin(k*X_0 - w*T) takes its parameters straight from
+    // the input database; the deformation velocity is dy/dt along the body normal.
+    TravelingWaveKinematics traveling_wave;
+    if (type == EelKinematics::TRAVELING_WAVE_KINEMATICS)
+    {
+        const double wave_amplitude = input_db->getDoubleWithDefault("wave_amplitude", d_base_amplitude);
+        const double envelope_offset = input_db->getDoubleWithDefault("envelope_offset", 0.0);
+        const double envelope_length = input_db->getDoubleWithDefault("envelope_length", LENGTH_FISH);
+        const double wave_envelope_power = input_db->getDoubleWithDefault("envelope_power", 1.0);
+        const double wave_number = input_db->getDouble("wave_number");
+        const double angular_frequency = input_db->getDouble("angular_frequency");
+        traveling_wave = TravelingWaveKinematics(wave_amplitude,
+                                                 envelope_offset,
+                                                 envelope_length,
+                                                 wave_envelope_power,
+                                                 wave_number,
+                                                 angular_frequency);
+    }
+
+    // Read the user constants that may appear in the kinematics expressions.
+    std::vector<std::string> constant_names;
+    std::vector<double> constant_values;
+    if (input_db->isDatabase("kinematics_constants"))
+    {
+        Pointer<Database> constants_db = input_db->getDatabase("kinematics_constants");
+        const Array<std::string> keys = constants_db->getAllKeys();
+        for (int k = 0; k < keys.getSize(); ++k)
+        {
+            constant_names.push_back(keys[k]);
+            constant_values.push_back(constants_db->getDouble(keys[k]));
+        }
+    }
+
+    // Set up one evaluation context per worker of the section loops.
+    int num_threads = input_db->getIntegerWithDefault("num_kinematics_threads", 1);
+#ifdef _OPENMP
+    if (num_threads <= 0) num_threads = omp_get_max_threads();
+#else
+    if (num_threads != 1)
+    {
+        TBOX_WARNING("IBEELKinematics::IBEELKinematics() :\n"
+                     << "  num_kinematics_threads = " << num_threads << " requires a build with OpenMP; "
+                     << "using 1 thread." << std::endl);
+        num_threads = 1;
+    }
+#endif
+    d_kinematics = EelKinematics(num_threads, constant_names, constant_values);
+    d_kinematics.setKinematicsType(type, traveling_wave);
+
+    // Only the body shape is given; its time derivative is obtained alongside it with dual numbers.
+    if (type == EelKinematics::AUTODIFF_KINEMATICS)
+    {
+        if (!d_kinematics.setFunction(EelKinematics::BODY_SHAPE_FUNCTION, input_db->getString("body_shape_equation")))
+        {
+            TBOX_ERROR("IBEELKinematics::IBEELKinematics() :\n"
+                       << "  could not compile body_shape_equation for AUTODIFF kinematics:\n  "
+                       << d_kinematics.getCompileError(EelKinematics::BODY_SHAPE_FUNCTION) << std::endl);
+        }
+        for (int d = 0; d < NDIM; ++d)
+        {
+            const std::string key_name = "deformation_velocity_function_" + std::to_string(d);
+            if (input_db->keyExists(key_name))
+            {
+                TBOX_WARNING("IBEELKinematics::IBEELKinematics() :\n"
+                             << "  ``" << key_name << " '' is ignored with AUTODIFF kinematics; the deformation "
+                             << "velocity is the time derivative of body_shape_equation." << std::endl);
+            }
+        }
+    }
+
+    // Optional phase-indexed cache of the periodic body-frame deformation; it requires a deformation
+    // velocity of the form dy/dt along the normal, i.e. the TRAVELING_WAVE or AUTODIFF kinematics.
+    if (input_db->getBoolWithDefault("use_shape_cache", false))
+    {
+        const int shape_cache_num_phases = input_db->getIntegerWithDefault("shape_cache_num_phases", 256);
+        const double shape_cache_tolerance = input_db->getDoubleWithDefault("shape_cache_tolerance", 1.0e-6);
+        const int shape_cache_check_interval = input_db->getIntegerWithDefault("shape_cache_check_interval", 0);
+        double shape_cache_period = 0.0;
+        if (type == EelKinematics::TRAVELING_WAVE_KINEMATICS)
+        {
+            shape_cache_period = input_db->getDoubleWithDefault(
+                "shape_cache_period", 2.0 * PII / std::abs(traveling_wave.getAngularFrequency()));
+        }
+        else if (type == EelKinematics::AUTODIFF_KINEMATICS)
+        {
+            shape_cache_period = input_db->getDouble("shape_cache_period");
+        }
+        try
+        {
+            d_kinematics.setShapeCache(
+                shape_cache_num_phases, shape_cache_period, shape_cache_tolerance, shape_cache_check_interval);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            TBOX_ERROR("IBEELKinematics::IBEELKinematics() :\n"
+                       << "  invalid shape cache settings: " << e.what() << std::endl);
+        }
+    }
+
+    // Optionally check that the kinematics update of each step makes no heap allocations.
+    d_check_step_allocations = input_db->getBoolWithDefault("check_step_allocations", false);
+    if (d_check_step_allocations && !AllocationCounter::isEnabled())
+    {
+        TBOX_WARNING("IBEELKinematics::IBEELKinematics() :\n"
+                     << "  check_step_allocations is ignored; configure with EEL2D_COUNT_ALLOCATIONS=ON to count "
+                     << "heap allocations." << std::endl);
+        d_check_step_allocations = false;
+    }
+
+    // Read-in deformation velocity functions and the body shape.
+    for (int d = 0; d < NDIM && type == EelKinematics::PARSER_KINEMATICS; ++d)
     {
         const std::string postfix = "_function_" + std::to_string(d);
         std::string key_name = "deformation_velocity" + postfix;
 
         if (input_db->isString(key_name))
         {
-            deformationvel_function_strings.push_back(input_db->getString(key_name));
+            d_kinematics.setFunction(EelKinematics::DEFORMATION_VELOCITY_FUNCTION + d, input_db->getString(key_name));
         }
         else
         {
-            deformationvel_function_strings.push_back("0.0");
+            d_kinematics.setFunction(EelKinematics::DEFORMATION_VELOCITY_FUNCTION + d, "0.0");
             TBOX_WARNING("IBEELKinematics::IBEELKinematics() :\n"
                          << "  no function corresponding to key ``" << key_name << " '' found for dimension = " << d
                          << "; using def_vel = 0.0. " << std::endl);
         }
-
-        d_deformationvel_parsers.push_back(new mu::Parser());
-        d_deformationvel_parsers.back()->SetExpr(deformationvel_function_strings.back());
-        d_all_parsers.push_back(d_deformationvel_parsers.back());
     }
-
-    // Read-in the body shape parser
+    if (type == EelKinematics::PARSER_KINEMATICS)
     {
-        const std::string body_shape_equation = input_db->getString("body_shape_equation");
-        d_body_shape_parser = new mu::Parser();
-        d_body_shape_parser->SetExpr(body_shape_equation);
-        d_all_parsers.push_back(d_body_shape_parser);
+        d_kinematics.setFunction(EelKinematics::BODY_SHAPE_FUNCTION, input_db->getString("body_shape_equation"));
     }
 
-    // Read in the maneuvering axis parser.
-    if (d_bodyIsManeuvering)
-    {
-        const std::string maneuvering_axis_equation = input_db->getString("maneuvering_axis_equation");
-        d_maneuvering_axis_parser = new mu::Parser();
-        d_maneuvering_axis_parser->SetExpr(maneuvering_axis_equation);
-        d_all_parsers.push_back(d_maneuvering_axis_parser);
-    }
-
-    // Define the default and the user-provided constants.
-    const double pi = 3.1415926535897932384626433832795;
-    for (std::vector<mu::Parser*>::const_iterator cit = d_all_parsers.begin(); cit != d_all_parsers.end(); ++cit)
+    // Read in the maneuvering axis, either as the curvature kappa(X_0, T) of the axis at arc length X_0 or
+    // as the axis y-coordinate as a function of X_0.
+    const bool maneuverAxisHasCurvatureLaw =
+        bodyIsManeuvering && input_db->keyExists("maneuvering_axis_curvature_equation");
+    if (maneuverAxisHasCurvatureLaw)
     {
-        // Various names for pi.
-        (*cit)->DefineConst("pi", pi);
-        (*cit)->DefineConst("Pi", pi);
-        (*cit)->DefineConst("PI", pi);
-
-        // Variables
-        (*cit)->DefineVar("T", &d_parser_time);
-        (*cit)->DefineVar("t", &d_parser_time);
-        for (int d = 0; d < NDIM; ++d)
+        if (maneuverAxisIsChangingShape)
         {
-            const std::string postfix = std::to_string(d);
-            (*cit)->DefineVar("X" + postfix, d_parser_posn.data() + d);
-            (*cit)->DefineVar("x" + postfix, d_parser_posn.data() + d);
-            (*cit)->DefineVar("X_" + postfix, d_parser_posn.data() + d);
-            (*cit)->DefineVar("x_" + postfix, d_parser_posn.data() + d);
-
-            (*cit)->DefineVar("N" + postfix, d_parser_normal.data() + d);
-            (*cit)->DefineVar("n" + postfix, d_parser_normal.data() + d);
-            (*cit)->DefineVar("N_" + postfix, d_parser_normal.data() + d);
-            (*cit)->DefineVar("n_" + postfix, d_parser_normal.data() + d);
+            TBOX_ERROR("IBEELKinematics::IBEELKinematics() :\n"
+                       << "  maneuvering_axis_curvature_equation cannot be combined with "
+                       << "maneuvering_axis_is_changing_shape = TRUE." << std::endl);
         }
+        d_kinematics.setFunction(EelKinematics::MANEUVERING_AXIS_CURVATURE_FUNCTION,
+                                 input_db->getString("maneuvering_axis_curvature_equation"));
+    }
+    else if (bodyIsManeuvering)
+    {
+        d_kinematics.setFunction(EelKinematics::MANEUVERING_AXIS_FUNCTION,
+                                 input_db->getString("maneuvering_axis_equation"));
     }
+    d_kinematics.setManeuvering(bodyIsManeuvering, maneuverAxisHasCurvatureLaw, maneuverAxisIsChangingShape);
+    d_kinematics.setInitialAngle(initAngle_bodyAxis_x);
+
+    // Expressions that could not be compiled are evaluated by muParser instances, one per context.
+    createFallbackParsers();
 
     // set the location of the food particle from the input file.
-    d_food_location.resizeArray(NDIM);
+    double food_location[NDIM];
     for (int dim = 0; dim < NDIM; ++dim)
     {
-        d_food_location[dim] = input_db->getDouble("food_location_in_domain_" + std::to_string(dim));
+        food_location[dim] = input_db->getDouble("food_location_in_domain_" + std::to_string(dim));
     }
+    d_kinematics.setFoodLocation(food_location);
 
     // set how the immersed body is layout in reference frame.
     setImmersedBodyLayout(patch_hierarchy);
@@ -181,6 +340,44 @@ IBEELKinematics::IBEELKinematics(const std::string& object_name,
     bool from_restart = RestartManager::getManager()->isFromRestart();
     if (from_restart) getFromRestart();
 
+    // Rank 0 writes the performance metrics from a background thread. A restarted run resumes the existing
+    // file, dropping the rows written after the restart dump.
+    if (d_track_performance && IBTK_MPI::getRank() == 0)
+    {
+        std::ostringstream header;
+        header << "# Performance Metrics for Undulatory Foil Propulsion\n"
+               << "# Reynolds number: " << d_reynolds_number << "\n"
+               << "# Thickness ratio: " << d_thickness_ratio << "\n"
+               << "# Swimming mode: " << d_swimming_mode << "\n"
+               << "# Columns: Time, Adapted_Amplitude, Adapted_Frequency, Swimming_Speed, "
+               << "Instantaneous_Thrust, Instantaneous_Power, Efficiency\n";
+        d_performance_writer.open(d_performance_log_file,
+                                  header.str(),
+                                  NUM_PERFORMANCE_COLUMNS,
+                                  from_restart,
+                                  d_current_time,
+                                  d_performance_flush_rows,
+                                  d_performance_flush_interval);
+
+        // One summary row per completed tail-beat cycle, written as soon as the cycle is completed.
+        std::ostringstream cycle_header;
+        cycle_header << "# Tail-beat cycle statistics for Undulatory Foil Propulsion\n"
+                     << "# Reynolds number: " << d_reynolds_number << "\n"
+                     << "# Thickness ratio: " << d_thickness_ratio << "\n"
+                     << "# Swimming mode: " << d_swimming_mode << "\n"
+                     << "# Time-weighted means and standard deviations over each cycle\n"
+                     << "# Columns: Cycle_End_Time, Cycle, Cycle_Start_Time, Mean_Swimming_Speed, "
+                     << "Std_Swimming_Speed, Mean_Thrust, Std_Thrust, Mean_Power, Std_Power, Mean_Efficiency, "
+                     << "Std_Efficiency, Mean_Adapted_Amplitude, Mean_Adapted_Frequency, Strouhal_Number\n";
+        d_cycle_writer.open(d_cycle_statistics_file,
+                            cycle_header.str(),
+                            NUM_CYCLE_COLUMNS,
+                            from_restart,
+                            d_current_time,
+                            /*flush_rows*/ 1,
+                            d_performance_flush_interval);
+    }
+
     return;
 
 } // IBEELKinematics
@@ -203,6 +400,14 @@ IBEELKinematics::putToDatabase(Pointer<Database> db)
     db->putDoubleArray("d_incremented_angle_from_reference_axis", &d_incremented_angle_from_reference_axis[0], 3);
     db->putDoubleArray("d_tagged_pt_position", &d_tagged_pt_position[0], 3);
 
+    std::vector<double> cycle_state;
+    d_cycle_statistics.getState(cycle_state);
+    db->putDoubleArray("d_cycle_statistics", cycle_state.data(), static_cast<int>(cycle_state.size()));
+
+    // Make sure that the metrics files cover the state being dumped.
+    d_performance_writer.flush();
+    d_cycle_writer.flush();
+
     return;
 
 } // putToDatabase
@@ -227,13 +432,20 @@ IBEELKinematics::getFromRestart()
     db->getDoubleArray("d_incremented_angle_from_reference_axis", &d_incremented_angle_from_reference_axis[0], 3);
     db->getDoubleArray("d_tagged_pt_position", &d_tagged_pt_position[0], 3);
 
+    // Restart files written before the cycle statistics existed start a new cycle.
+    if (db->keyExists("d_cycle_statistics"))
+    {
+        std::vector<double> cycle_state(db->getArraySize("d_cycle_statistics"));
+        db->getDoubleArray("d_cycle_statistics", cycle_state.data(), static_cast<int>(cycle_state.size()));
+        d_cycle_statistics.setState(cycle_state);
+    }
+
     return;
 } // getFromRestart
 
 void
 IBEELKinematics::setImmersedBodyLayout(Pointer<PatchHierarchy<NDIM> > patch_hierarchy)
 {
-    // Set some vector sizes.
     const StructureParameters& struct_param = getStructureParameters();
     const int coarsest_ln = struct_param.getCoarsestLevelNumber();
     const int finest_ln = struct_param.getFinestLevelNumber();
@@ -241,319 +453,93 @@ IBEELKinematics::setImmersedBodyLayout(Pointer<PatchHierarchy<NDIM> > patch_hier
     const std::vector<std::pair<int, int> >& idx_range = struct_param.getLagIdxRange();
     const int total_lag_pts = idx_range[0].second - idx_range[0].first;
 
-    for (int d = 0; d < NDIM; ++d)
-    {
-        d_kinematics_vel[d].resize(total_lag_pts);
-        d_shape[d].resize(total_lag_pts);
-    }
-
     // Get Background mesh related data.
     Pointer<PatchLevel<NDIM> > level = patch_hierarchy->getPatchLevel(finest_ln);
     PatchLevel<NDIM>::Iterator p(level);
     Pointer<Patch<NDIM> > patch = level->getPatch(p());
     Pointer<CartesianPatchGeometry<NDIM> > pgeom = patch->getPatchGeometry();
     const double* const dx = pgeom->getDx();
-    for (int dim = 0; dim < NDIM; ++dim)
-    {
-        d_mesh_width[dim] = dx[dim];
-    }
-
-    // No. of points on the backbone and till head.
-    const int BodyNx = static_cast<int>(ceil(LENGTH_FISH / d_mesh_width[0]));
-    const int HeadNx = static_cast<int>(ceil(LENGTH_HEAD / d_mesh_width[0]));
 
-    d_ImmersedBodyData.clear();
-    for (int i = 1; i <= HeadNx; ++i)
+    // The body laid out by the kinematics core must match the Lagrangian structure read from the vertex file.
+    try
     {
-        const double s = (i - 1) * d_mesh_width[0];
-        const double section = sqrt(2 * WIDTH_HEAD * s - s * s);
-        const int NumPtsInSection = 2 * static_cast<int>(ceil(section / d_mesh_width[1]));
-        d_ImmersedBodyData.insert(std::make_pair(s, NumPtsInSection));
+        const int num_body_pts = d_kinematics.setBodyLayout(dx, d_current_time);
+        if (num_body_pts != total_lag_pts)
+        {
+            TBOX_ERROR(d_object_name << "::setImmersedBodyLayout() :\n"
+                                     << "  the body has " << num_body_pts << " points for this mesh width, but the "
+                                     << "structure has " << total_lag_pts << " points." << std::endl);
+        }
     }
-
-    for (int i = HeadNx + 1; i <= BodyNx; ++i)
+    catch (const std::runtime_error& e)
     {
-        const double s = (i - 1) * d_mesh_width[0];
-        const double section = WIDTH_HEAD * (LENGTH_FISH - s) / (LENGTH_FISH - LENGTH_HEAD);
-        const int NumPtsInHeight = 2 * static_cast<int>(ceil(section / d_mesh_width[1]));
-        d_ImmersedBodyData.insert(std::make_pair(s, NumPtsInHeight));
+        TBOX_ERROR(d_object_name << "::setImmersedBodyLayout() :\n  " << e.what() << std::endl);
     }
-
-    // Find the coordinates of the axis of maneuvering in the reference frame from the input file.
-    if (d_bodyIsManeuvering)
+    if (d_kinematics.getShapeCachePeriod() > 0.0)
     {
-        d_maneuverAxisReferenceCoordinates_vec.clear();
-        d_map_reference_tangent.clear();
-        d_map_reference_sign.clear();
-
-        std::vector<double> vec_axis_coord(2);
-        for (std::map<double, int>::const_iterator mitr = d_ImmersedBodyData.begin(); mitr != d_ImmersedBodyData.end();
-             ++mitr)
-        {
-            d_parser_posn[0] = mitr->first;
-            vec_axis_coord[0] = mitr->first;
-            vec_axis_coord[1] = d_maneuvering_axis_parser->Eval();
-            d_maneuverAxisReferenceCoordinates_vec.push_back(vec_axis_coord);
-        }
-
-        // store the tangents to the reference maneuver axis in a reference_map.
-        for (unsigned int i = 0; i <= (d_maneuverAxisReferenceCoordinates_vec.size() - 2); ++i)
-        {
-            std::vector<int> sign_vec(2);
-            const double s = d_maneuverAxisReferenceCoordinates_vec[i][0];
-            const double dX =
-                (d_maneuverAxisReferenceCoordinates_vec[i + 1][0] - d_maneuverAxisReferenceCoordinates_vec[i][0]);
-            const double dY =
-                (d_maneuverAxisReferenceCoordinates_vec[i + 1][1] - d_maneuverAxisReferenceCoordinates_vec[i][1]);
-            sign_vec[0] = sign(dX);
-            sign_vec[1] = sign(dY);
-            const double theta = std::atan(std::abs(dY / dX));
-            d_map_reference_tangent.insert(std::make_pair(s, theta));
-            d_map_reference_sign.insert(std::make_pair(s, sign_vec));
-        }
-
-        // Fill in the last point in the map.
-        d_map_reference_tangent.insert(std::make_pair((d_maneuverAxisReferenceCoordinates_vec.back())[0],
-                                                      (d_map_reference_tangent.rbegin())->second));
-        d_map_reference_sign.insert(std::make_pair((d_maneuverAxisReferenceCoordinates_vec.back())[0],
-                                                   (d_map_reference_sign.rbegin())->second));
-
-        // Find the COM of the maneuver axis.
-        double maneuverAxis_x_cm = 0.0;
-        double maneuverAxis_y_cm = 0.0;
-        for (unsigned int i = 0; i < d_maneuverAxisReferenceCoordinates_vec.size(); ++i)
-        {
-            maneuverAxis_x_cm += d_maneuverAxisReferenceCoordinates_vec[i][0];
-            maneuverAxis_y_cm += d_maneuverAxisReferenceCoordinates_vec[i][1];
-        }
-        maneuverAxis_x_cm /= d_maneuverAxisReferenceCoordinates_vec.size();
-        maneuverAxis_y_cm /= d_maneuverAxisReferenceCoordinates_vec.size();
-
-        // Shift the reference so that maneuver Axis coordinate COM coincides with the origin.
-        for (unsigned int i = 0; i < d_maneuverAxisReferenceCoordinates_vec.size(); ++i)
-        {
-            d_maneuverAxisReferenceCoordinates_vec[i][0] -= maneuverAxis_x_cm;
-            d_maneuverAxisReferenceCoordinates_vec[i][1] -= maneuverAxis_y_cm;
-        }
-    } // body is maneuvering
+        plog << d_object_name << "::setImmersedBodyLayout(): tabulated the shape cache over period "
+             << d_kinematics.getShapeCachePeriod() << ", max interpolation error "
+             << d_kinematics.getShapeCacheError() << "\n";
+    }
 
     return;
 
 } // setImmersedBodyLayout
 
 void
-IBEELKinematics::transformManeuverAxisAndCalculateTangents(const double angleFromHorizontal)
-{
-    d_maneuverAxisTransformedCoordinates_vec.clear();
-    d_map_transformed_tangent.clear();
-    d_map_transformed_sign.clear();
-
-    const int BodyNx = static_cast<int>(ceil(LENGTH_FISH / d_mesh_width[0]));
-    std::vector<double> transformed_coord(2);
-    for (int i = 0; i <= (BodyNx - 1); ++i)
-    {
-        transformed_coord[0] = d_maneuverAxisReferenceCoordinates_vec[i][0] * cos(angleFromHorizontal) -
-                               d_maneuverAxisReferenceCoordinates_vec[i][1] * sin(angleFromHorizontal);
-        transformed_coord[1] = d_maneuverAxisReferenceCoordinates_vec[i][0] * sin(angleFromHorizontal) +
-                               d_maneuverAxisReferenceCoordinates_vec[i][1] * cos(angleFromHorizontal);
-        d_maneuverAxisTransformedCoordinates_vec.push_back(transformed_coord);
-    }
-
-    for (int i = 0; i <= (BodyNx - 2); ++i)
-    {
-        std::vector<int> sign_vec(2);
-        const double s = i * d_mesh_width[0];
-        const double dX =
-            (d_maneuverAxisTransformedCoordinates_vec[i + 1][0] - d_maneuverAxisTransformedCoordinates_vec[i][0]);
-        const double dY =
-            (d_maneuverAxisTransformedCoordinates_vec[i + 1][1] - d_maneuverAxisTransformedCoordinates_vec[i][1]);
-        sign_vec[0] = sign(dX);
-        sign_vec[1] = sign(dY);
-        const double theta = std::atan(std::abs(dY / dX));
-        d_map_transformed_tangent.insert(std::make_pair(s, theta));
-        d_map_transformed_sign.insert(std::make_pair(s, sign_vec));
-    }
-
-    // Fill in the last point in the map.
-    d_map_transformed_tangent.insert(
-        std::make_pair((BodyNx - 1) * d_mesh_width[0], (d_map_transformed_tangent.rbegin())->second));
-    d_map_transformed_sign.insert(
-        std::make_pair((BodyNx - 1) * d_mesh_width[0], (d_map_transformed_sign.rbegin())->second));
-
-    return;
-
-} // transformManeuverAxisAndCalculateTangents
-
-void
-IBEELKinematics::setEelSpecificVelocity(const double time,
-                                        const std::vector<double>& incremented_angle_from_reference_axis,
-                                        const std::vector<double>& center_of_mass,
-                                        const std::vector<double>& tagged_pt_position)
+IBEELKinematics::createFallbackParsers()
 {
-    d_parser_time = time;
-    const double angleFromHorizontal = d_initAngle_bodyAxis_x + incremented_angle_from_reference_axis[2];
-
-    if (d_bodyIsManeuvering)
+    const double pi = 3.1415926535897932384626433832795;
+    const std::vector<std::string>& constant_names = d_kinematics.getConstantNames();
+    for (int function = 0; function < EelKinematics::NUM_FUNCTIONS; ++function)
     {
-        if (d_maneuverAxisIsChangingShape)
-        {
-            // calculate the radius of the circular path on which the fish will have its backbone.
-            double radius_circular_path;
-            std::vector<double> bodyline_vector(NDIM), foodline_vector(NDIM);
-            double mag_bodyline_vector = 0.0, mag_foodline_vector = 0.0;
-
-            for (int dim = 0; dim < NDIM; ++dim)
-            {
-                bodyline_vector[dim] = tagged_pt_position[dim] - center_of_mass[dim];
-                foodline_vector[dim] = d_food_location[dim] - tagged_pt_position[dim];
-                mag_bodyline_vector += std::pow(bodyline_vector[dim], 2);
-                mag_foodline_vector += std::pow(foodline_vector[dim], 2);
-            }
-
-            // Normalize the vectors.
-            for (int dim = 0; dim < NDIM; ++dim)
-            {
-                bodyline_vector[dim] /= sqrt(mag_bodyline_vector);
-                foodline_vector[dim] /= sqrt(mag_foodline_vector);
-            }
-
-            // Find the angle between bodyline_axis and foodline_axis
-            // angle = sign(aXb)* acos(a.b/|a||b|)
-            const double angle_bw_target_vision =
-                sign(bodyline_vector[0] * foodline_vector[1] - bodyline_vector[1] * foodline_vector[0]) *
-                std::acos(bodyline_vector[0] * foodline_vector[0] + bodyline_vector[1] * foodline_vector[1]);
-
-            if (angle_bw_target_vision >= CUT_OFF_ANGLE)
-            {
-                radius_circular_path = CUT_OFF_RADIUS;
-            }
-            else if (angle_bw_target_vision <= -CUT_OFF_ANGLE)
-            {
-                radius_circular_path = CUT_OFF_RADIUS;
-            }
-            else if (IBTK::abs_equal_eps(MathUtilities<double>::Abs(angle_bw_target_vision), 0.0))
-            {
-                radius_circular_path = __INFINITY;
-            }
-            else if (angle_bw_target_vision >= -LOWER_CUT_OFF_ANGLE && angle_bw_target_vision <= LOWER_CUT_OFF_ANGLE)
-            {
-                radius_circular_path = std::abs(CUT_OFF_RADIUS * std::pow((CUT_OFF_ANGLE / LOWER_CUT_OFF_ANGLE), 1));
-            }
-            else
-            {
-                radius_circular_path = std::abs(CUT_OFF_RADIUS * std::pow((CUT_OFF_ANGLE / angle_bw_target_vision), 1));
-            }
-            // set the reference maneuver axis coordinates.
-            const int BodyNx = static_cast<int>(ceil(LENGTH_FISH / d_mesh_width[0]));
-            if (radius_circular_path != __INFINITY)
-            {
-                const double angle_sector = LENGTH_FISH / radius_circular_path;
-                const double dtheta = angle_sector / (BodyNx - 1);
-
-                d_maneuverAxisReferenceCoordinates_vec.clear();
-                std::vector<double> vec_axis_coord(2);
-                for (int i = 1; i <= BodyNx; ++i)
-                {
-                    const double angleFromVertical = -angle_sector / 2 + (i - 1) * dtheta;
-                    vec_axis_coord[0] = radius_circular_path * sin(angleFromVertical);
-                    vec_axis_coord[1] = radius_circular_path * cos(angleFromVertical);
-                    d_maneuverAxisReferenceCoordinates_vec.push_back(vec_axis_coord);
-                }
-            }
-            else
-            {
-                d_maneuverAxisReferenceCoordinates_vec.clear();
-                std::vector<double> vec_axis_coord(2);
-                for (int i = 1; i <= BodyNx; ++i)
-                {
-                    vec_axis_coord[0] = (i - 1) * d_mesh_width[0];
-                    vec_axis_coord[1] = 0.0;
-                    d_maneuverAxisReferenceCoordinates_vec.push_back(vec_axis_coord);
-                }
-            }
+        if (!d_kinematics.isUsed(function) || d_kinematics.isCompiled(function)) continue;
 
-            // Find the COM of the maneuver axis.
-            double maneuverAxis_x_cm = 0.0;
-            double maneuverAxis_y_cm = 0.0;
-            for (unsigned int i = 0; i < d_maneuverAxisReferenceCoordinates_vec.size(); ++i)
+        TBOX_WARNING("IBEELKinematics::IBEELKinematics() :\n"
+                     << "  ``" << d_kinematics.getExpression(function) << " '' is evaluated with muParser:\n  "
+                     << d_kinematics.getCompileError(function) << std::endl);
+        for (int k = 0; k < d_kinematics.getNumberOfWorkers(); ++k)
+        {
+            KinematicsEvaluationContext& variables = d_kinematics.getEvaluationVariables(k);
+            mu::Parser* parser = new mu::Parser();
+            parser->SetExpr(d_kinematics.getExpression(function));
+
+            // Various names for pi.
+            parser->DefineConst("pi", pi);
+            parser->DefineConst("Pi", pi);
+            parser->DefineConst("PI", pi);
+
+            // Variables, including the user constants whose values belong to the context.
+            parser->DefineVar("T", &variables.time);
+            parser->DefineVar("t", &variables.time);
+            for (int d = 0; d < NDIM; ++d)
             {
-                maneuverAxis_x_cm += d_maneuverAxisReferenceCoordinates_vec[i][0];
-                maneuverAxis_y_cm += d_maneuverAxisReferenceCoordinates_vec[i][1];
+                const std::string postfix = std::to_string(d);
+                parser->DefineVar("X" + postfix, variables.posn.data() + d);
+                parser->DefineVar("x" + postfix, variables.posn.data() + d);
+                parser->DefineVar("X_" + postfix, variables.posn.data() + d);
+                parser->DefineVar("x_" + postfix, variables.posn.data() + d);
+
+                parser->DefineVar("N" + postfix, variables.normal.data() + d);
+                parser->DefineVar("n" + postfix, variables.normal.data() + d);
+                parser->DefineVar("N_" + postfix, variables.normal.data() + d);
+                parser->DefineVar("n_" + postfix, variables.normal.data() + d);
             }
-            maneuverAxis_x_cm /= d_maneuverAxisReferenceCoordinates_vec.size();
-            maneuverAxis_y_cm /= d_maneuverAxisReferenceCoordinates_vec.size();
-
-            // Shift the reference so that maneuver Axis coordinate COM coincides with the origin.
-            for (unsigned int i = 0; i < d_maneuverAxisReferenceCoordinates_vec.size(); ++i)
+            for (std::size_t c = 0; c < constant_names.size(); ++c)
             {
-                d_maneuverAxisReferenceCoordinates_vec[i][0] -= maneuverAxis_x_cm;
-                d_maneuverAxisReferenceCoordinates_vec[i][1] -= maneuverAxis_y_cm;
+                parser->DefineVar(constant_names[c], variables.constants.data() + c);
             }
 
-            // Find the tangents on this reference axis for shape update.
-            d_map_reference_tangent.clear();
-            d_map_reference_sign.clear();
-            for (int i = 0; i <= (BodyNx - 2); ++i)
-            {
-                std::vector<int> sign_vec(2);
-                const double s = i * d_mesh_width[0];
-                const double dX =
-                    (d_maneuverAxisReferenceCoordinates_vec[i + 1][0] - d_maneuverAxisReferenceCoordinates_vec[i][0]);
-                const double dY =
-                    (d_maneuverAxisReferenceCoordinates_vec[i + 1][1] - d_maneuverAxisReferenceCoordinates_vec[i][1]);
-                sign_vec[0] = sign(dX);
-                sign_vec[1] = sign(dY);
-                const double theta = std::atan(std::abs(dY / dX));
-                d_map_reference_tangent.insert(std::make_pair(s, theta));
-                d_map_reference_sign.insert(std::make_pair(s, sign_vec));
-            }
-            // Fill in the last point in the map.
-            d_map_reference_tangent.insert(
-                std::make_pair((BodyNx - 1) * d_mesh_width[0], (d_map_reference_tangent.rbegin())->second));
-            d_map_reference_sign.insert(
-                std::make_pair((BodyNx - 1) * d_mesh_width[0], (d_map_reference_sign.rbegin())->second));
-        } // maneuverAxisIsChangingShape
-
-        // Rotate the reference axis and calculate tangents in the rotated frame.
-        transformManeuverAxisAndCalculateTangents(angleFromHorizontal);
-    } // bodyIsManeuvering
-
-    // Set the deformation velocity in the body frame.
-    std::vector<double> vec_vel(NDIM);
-    int lag_idx = 0;
-    for (std::map<double, int>::const_iterator itr = d_ImmersedBodyData.begin(); itr != d_ImmersedBodyData.end(); itr++)
-    {
-        d_parser_posn[0] = itr->first;
-        const int NumPtsInSection = itr->second;
-
-        if (d_bodyIsManeuvering)
-        {
-            d_parser_normal[0] =
-                -sin(d_map_transformed_tangent[d_parser_posn[0]]) * d_map_transformed_sign[d_parser_posn[0]][1];
-            d_parser_normal[1] =
-                cos(d_map_transformed_tangent[d_parser_posn[0]]) * d_map_transformed_sign[d_parser_posn[0]][0];
-        }
-        else
-        {
-            d_parser_normal[0] = -sin(angleFromHorizontal);
-            d_parser_normal[1] = cos(angleFromHorizontal);
-        }
+            // Evaluate once so that muParser compiles its bytecode here rather than during the first step.
+            parser->Eval();
 
-        vec_vel[0] = d_deformationvel_parsers[0]->Eval();
-        vec_vel[1] = d_deformationvel_parsers[1]->Eval();
-
-        const int lowerlimit = lag_idx;
-        const int upperlimit = lag_idx + NumPtsInSection;
-        for (int d = 0; d < NDIM; ++d)
-        {
-            for (int i = lowerlimit; i < upperlimit; ++i) d_kinematics_vel[d][i] = vec_vel[d];
+            d_kinematics.setFallbackFunction(function, k, [parser]() { return parser->Eval(); });
+            d_all_parsers.push_back(parser);
         }
-
-        lag_idx = upperlimit;
     }
-
     return;
-} // setEelSpecificVelocity
+} // createFallbackParsers
+
 
 void
 IBEELKinematics::setKinematicsVelocity(const double time,
@@ -561,10 +547,17 @@ IBEELKinematics::setKinematicsVelocity(const double time,
                                        const std::vector<double>& center_of_mass,
                                        const std::vector<double>& tagged_pt_position)
 {
+    IBAMR_TIMER_START(t_set_kinematics_velocity);
+
+    // Copy into the preallocated members rather than assigning, which could reallocate them.
     d_new_time = time;
-    d_incremented_angle_from_reference_axis = incremented_angle_from_reference_axis;
-    d_center_of_mass = center_of_mass;
-    d_tagged_pt_position = tagged_pt_position;
+    std::copy(incremented_angle_from_reference_axis.begin(),
+              incremented_angle_from_reference_axis.begin() + d_incremented_angle_from_reference_axis.size(),
+              d_incremented_angle_from_reference_axis.begin());
+    std::copy(center_of_mass.begin(), center_of_mass.begin() + d_center_of_mass.size(), d_center_of_mass.begin());
+    std::copy(tagged_pt_position.begin(),
+              tagged_pt_position.begin() + d_tagged_pt_position.size(),
+              d_tagged_pt_position.begin());
 
     // Calculate adaptive kinematics based on Reynolds number and thickness
     if (d_enable_shape_adaptation)
@@ -572,17 +565,22 @@ IBEELKinematics::setKinematicsVelocity(const double time,
         calculateAdaptiveKinematics(time);
     }
 
-    setEelSpecificVelocity(d_new_time, d_incremented_angle_from_reference_axis, d_center_of_mass, d_tagged_pt_position);
+    const unsigned long long start_allocation_count = AllocationCounter::getCount();
+    const double incremented_angle = d_incremented_angle_from_reference_axis[2];
 
-    // Write performance metrics periodically
-    static double last_write_time = -1.0;
-    const double write_interval = 0.1;  // Write every 0.1 time units
-    if (d_track_performance && (time - last_write_time >= write_interval || last_write_time < 0.0))
-    {
-        writePerformanceMetrics(time);
-        last_write_time = time;
-    }
+    IBAMR_TIMER_START(t_update_maneuver_axis);
+    d_kinematics.updateManeuverAxis(
+        d_new_time, incremented_angle, d_center_of_mass.data(), d_tagged_pt_position.data());
+    IBAMR_TIMER_STOP(t_update_maneuver_axis);
+
+    IBAMR_TIMER_START(t_set_section_velocity);
+    d_kinematics.setVelocity(d_new_time, incremented_angle);
+    IBAMR_TIMER_STOP(t_set_section_velocity);
 
+    checkStepAllocations("setKinematicsVelocity()", start_allocation_count);
+    checkShapeCache();
+
+    IBAMR_TIMER_STOP(t_set_kinematics_velocity);
     return;
 
 } // setNewKinematicsVelocity
@@ -590,122 +588,49 @@ IBEELKinematics::setKinematicsVelocity(const double time,
 const std::vector<std::vector<double> >&
 IBEELKinematics::getKinematicsVelocity(const int /*level*/) const
 {
-    return d_kinematics_vel;
+    return d_kinematics.getVelocity();
 
 } // getKinematicsVelocity
 
 void
 IBEELKinematics::setShape(const double time, const std::vector<double>& /*incremented_angle_from_reference_axis*/)
 {
+    const unsigned long long start_allocation_count = AllocationCounter::getCount();
     const StructureParameters& struct_param = getStructureParameters();
-    const std::string position_update_method = struct_param.getPositionUpdateMethod();
+    const std::string& position_update_method = struct_param.getPositionUpdateMethod();
     if (position_update_method == "CONSTRAINT_VELOCITY") return;
 
+    IBAMR_TIMER_START(t_set_shape);
+
     // Find the deformed shape. Rotate the shape about center of mass.
     TBOX_ASSERT(d_new_time == time);
-    d_parser_time = time;
-    std::vector<double> shape_new(NDIM);
-
-    int lag_idx = -1;
-    int reference_axis_idx = -1;
-    for (std::map<double, int>::const_iterator itr = d_ImmersedBodyData.begin(); itr != d_ImmersedBodyData.end(); itr++)
-    {
-        const int NumPtsInSection = itr->second;
-        d_parser_posn[0] = itr->first;
-        const double y_shape_base = d_body_shape_parser->Eval();
-
-        if (d_bodyIsManeuvering)
-        {
-            ++reference_axis_idx;
-            const double x_maneuver_base = d_maneuverAxisReferenceCoordinates_vec[reference_axis_idx][0];
-            const double y_maneuver_base = d_maneuverAxisReferenceCoordinates_vec[reference_axis_idx][1];
-
-            for (int j = 1; j <= NumPtsInSection / 2; ++j)
-            {
-                const double nx = (-1 * sin(d_map_reference_tangent[itr->first]) * d_map_reference_sign[itr->first][1]);
-                const double ny = (cos(d_map_reference_tangent[itr->first]) * d_map_reference_sign[itr->first][0]);
-
-                shape_new[0] = x_maneuver_base + (y_shape_base + (j - 1) * d_mesh_width[1]) * nx;
-                shape_new[1] = y_maneuver_base + (y_shape_base + (j - 1) * d_mesh_width[1]) * ny;
-
-                d_shape[0][++lag_idx] = shape_new[0];
-                d_shape[1][lag_idx] = shape_new[1];
-            }
-
-            for (int j = 1; j <= NumPtsInSection / 2; ++j)
-            {
-                const double nx = (-1 * sin(d_map_reference_tangent[itr->first]) * d_map_reference_sign[itr->first][1]);
-                const double ny = (cos(d_map_reference_tangent[itr->first]) * d_map_reference_sign[itr->first][0]);
-
-                shape_new[0] = x_maneuver_base + (y_shape_base - (j)*d_mesh_width[1]) * nx;
-                shape_new[1] = y_maneuver_base + (y_shape_base - (j)*d_mesh_width[1]) * ny;
-
-                d_shape[0][++lag_idx] = shape_new[0];
-                d_shape[1][lag_idx] = shape_new[1];
-            }
-        } // bodyIsManeuvering.
-        else
-        {
-            for (int j = 1; j <= NumPtsInSection / 2; ++j)
-            {
-                d_shape[0][++lag_idx] = itr->first;
-                d_shape[1][lag_idx] = y_shape_base + (j - 1) * d_mesh_width[1];
-            }
-
-            for (int j = 1; j <= NumPtsInSection / 2; ++j)
-            {
-                d_shape[0][++lag_idx] = itr->first;
-                d_shape[1][lag_idx] = y_shape_base - j * d_mesh_width[1];
-            }
-        }
-    }
-
-    // Find the c.m of this new shape.
-    std::vector<double> center_of_mass(NDIM, 0.0);
-    const int total_lag_pts = d_shape[0].size();
-    for (int d = 0; d < NDIM; ++d)
-    {
-        for (std::vector<double>::const_iterator citr = d_shape[d].begin(); citr != d_shape[d].end(); ++citr)
-        {
-            center_of_mass[d] += *citr;
-        }
-    }
-
-    for (int d = 0; d < NDIM; ++d) center_of_mass[d] /= total_lag_pts;
-
-    // Shift the c.m to the origin to apply the rotation
-    for (int d = 0; d < NDIM; ++d)
-    {
-        for (std::vector<double>::iterator itr = d_shape[d].begin(); itr != d_shape[d].end(); ++itr)
-        {
-            *itr -= center_of_mass[d];
-        }
-    }
+    IBAMR_TIMER_START(t_set_section_shape);
+    d_kinematics.generateShape(time);
+    IBAMR_TIMER_STOP(t_set_section_shape);
 
-    // Now rotate the shape about origin or center of mass.
-    const double angleFromHorizontal = d_initAngle_bodyAxis_x + d_incremented_angle_from_reference_axis[2];
-    for (int i = 0; i < total_lag_pts; ++i)
-    {
-        const double x_rotated = d_shape[0][i] * cos(angleFromHorizontal) - d_shape[1][i] * sin(angleFromHorizontal);
-        const double y_rotated = d_shape[0][i] * sin(angleFromHorizontal) + d_shape[1][i] * cos(angleFromHorizontal);
-        d_shape[0][i] = x_rotated;
-        d_shape[1][i] = y_rotated;
-    }
+    IBAMR_TIMER_START(t_transform_shape);
+    d_kinematics.transformShape(d_incremented_angle_from_reference_axis[2]);
+    IBAMR_TIMER_STOP(t_transform_shape);
 
     d_current_time = d_new_time;
+    checkStepAllocations("setShape()", start_allocation_count);
+    checkShapeCache();
 
+    IBAMR_TIMER_STOP(t_set_shape);
     return;
 } // setShape
 
 const std::vector<std::vector<double> >&
 IBEELKinematics::getShape(const int /*level*/) const
 {
-    return d_shape;
+    return d_kinematics.getShape();
 } // getShape
 
 void
 IBEELKinematics::calculateAdaptiveKinematics(const double time)
 {
+    IBAMR_TIMER_START(t_calculate_adaptive_kinematics);
+
     // Implement Reynolds number dependent adaptive kinematics
     // Based on research showing that swimming parameters vary with Re
 
@@ -767,15 +692,13 @@ IBEELKinematics::calculateAdaptiveKinematics(const double time)
     // This affects the deformation velocity calculation
 
     // Log adaptation (first time and periodically)
-    static bool first_call = true;
     const double log_interval = 1.0;  // Log every 1 time unit
-    static double last_log_time = -log_interval;
-
-    if (first_call || (time - last_log_time) >= log_interval)
+    if (d_last_adaptation_log_time < 0.0 || (time - d_last_adaptation_log_time) >= log_interval)
     {
         if (IBTK_MPI::getRank() == 0)
         {
-            std::cout << "\n=== Adaptive Kinematics Update (t=" << time << ") ===" << std::endl;
+            std::cout << "\n=== Adaptive Kinematics Update for " << d_object_name << " (t=" << time << ") ==="
+                      << std::endl;
             std::cout << "Reynolds number: " << d_reynolds_number << std::endl;
             std::cout << "Thickness ratio (h/L): " << d_thickness_ratio << std::endl;
             std::cout << "Swimming mode: " << (d_swimming_mode < 0.5 ? "Anguilliform" : "Carangiform") << std::endl;
@@ -785,61 +708,215 @@ IBEELKinematics::calculateAdaptiveKinematics(const double time)
             std::cout << "Envelope power: " << d_envelope_power << std::endl;
             std::cout << "=========================================\n" << std::endl;
         }
-        first_call = false;
-        last_log_time = time;
+        d_last_adaptation_log_time = time;
     }
 
+    IBAMR_TIMER_STOP(t_calculate_adaptive_kinematics);
     return;
 } // calculateAdaptiveKinematics
 
 void
-IBEELKinematics::writePerformanceMetrics(const double time)
+IBEELKinematics::updatePerformanceMetrics(const double time,
+                                          const double dt,
+                                          const double rho,
+                                          const std::vector<double>& com_velocity)
 {
     if (!d_track_performance) return;
 
-    // Open file in append mode
-    static bool file_initialized = false;
+    IBAMR_TIMER_START(t_update_performance_metrics);
 
-    if (IBTK_MPI::getRank() == 0)
+    const EelSectionTable& sections = d_kinematics.getSections();
+    const std::vector<std::vector<double> >& kinematics_vel = d_kinematics.getVelocity();
+    const double* const mesh_width = d_kinematics.getMeshWidth();
+    d_swimming_speed = 0.0;
+    for (int d = 0; d < NDIM; ++d) d_swimming_speed += com_velocity[d] * com_velocity[d];
+    d_swimming_speed = std::sqrt(d_swimming_speed);
+
+    // Swim along the COM velocity; before the body picks up speed, towards the head along the body axis, which
+    // points from head to tail.
+    double swim_dir[NDIM];
+    for (int d = 0; d < NDIM; ++d) swim_dir[d] = 0.0;
+    if (d_swimming_speed > 1.0e-12)
     {
-        std::ofstream outfile;
+        for (int d = 0; d < NDIM; ++d) swim_dir[d] = com_velocity[d] / d_swimming_speed;
+    }
+    else
+    {
+        const double body_angle = d_kinematics.getInitialAngle() + d_incremented_angle_from_reference_axis[2];
+        swim_dir[0] = -std::cos(body_angle);
+        swim_dir[1] = -std::sin(body_angle);
+        const double norm = std::sqrt(swim_dir[0] * swim_dir[0] + swim_dir[1] * swim_dir[1]);
+        for (int d = 0; d < NDIM; ++d) swim_dir[d] = norm > 0.0 ? swim_dir[d] / norm : 0.0;
+    }
 
-        if (!file_initialized)
-        {
-            outfile.open(d_performance_log_file.c_str(), std::ios::out);
-            outfile << "# Performance Metrics for Undulatory Foil Propulsion" << std::endl;
-            outfile << "# Reynolds number: " << d_reynolds_number << std::endl;
-            outfile << "# Thickness ratio: " << d_thickness_ratio << std::endl;
-            outfile << "# Swimming mode: " << d_swimming_mode << std::endl;
-            outfile << "# Columns: Time, Adapted_Amplitude, Adapted_Frequency, Swimming_Speed, "
-                    << "Instantaneous_Thrust, Instantaneous_Power, Efficiency" << std::endl;
-            file_initialized = true;
-        }
-        else
+    // Rank-local partial sums of the thrust and the power.
+    const StructureParameters& struct_param = getStructureParameters();
+    const int ln = struct_param.getFinestLevelNumber();
+    const int lag_idx_offset = struct_param.getLagIdxRange()[0].first;
+    double dV = 1.0;
+    for (int d = 0; d < NDIM; ++d) dV *= mesh_width[d];
+    const double force_scale = rho * dV / dt;
+
+    double sums[2] = { 0.0, 0.0 };
+    if (d_l_data_manager->levelContainsLagrangianData(ln))
+    {
+        Pointer<LData> U_correction_data = d_l_data_manager->getLData("U_correction", ln);
+        const boost::multi_array_ref<double, 2>& U_correction = *U_correction_data->getLocalFormVecArray();
+        const std::vector<LNode*>& local_nodes = d_l_data_manager->getLMesh(ln)->getLocalNodes();
+        for (std::vector<LNode*>::const_iterator it = local_nodes.begin(); it != local_nodes.end(); ++it)
         {
-            outfile.open(d_performance_log_file.c_str(), std::ios::app);
+            const int lag_idx = (*it)->getLagrangianIndex() - lag_idx_offset;
+            if (lag_idx < 0 || lag_idx >= sections.getNumberOfPoints()) continue;
+            const int local_idx = (*it)->getLocalPETScIndex();
+
+            // Force of the fluid on the body point, which is opposite to the constraint force on the fluid.
+            double axial_force = 0.0, power = 0.0;
+            for (int d = 0; d < NDIM; ++d)
+            {
+                const double F = -force_scale * U_correction[local_idx][d];
+                axial_force += F * swim_dir[d];
+                power -= F * kinematics_vel[d][lag_idx];
+            }
+            sums[0] += std::max(axial_force, 0.0);
+            sums[1] += power;
         }
+        U_correction_data->restoreArrays();
+    }
+    IBTK_MPI::sumReduction(sums, 2);
+    d_instantaneous_thrust = sums[0];
+    d_instantaneous_power = sums[1];
+
+    // Calculate Froude efficiency: eta = (Thrust * Speed) / Power
+    d_instantaneous_efficiency = 0.0;
+    if (std::abs(d_instantaneous_power) > 1e-10)
+    {
+        d_instantaneous_efficiency = (d_instantaneous_thrust * d_swimming_speed) / d_instantaneous_power;
+    }
+
+    // Accumulate the cycle statistics; the values are the same on all ranks.
+    const double cycle_sample[CycleStatistics::NUM_QUANTITIES] = { d_swimming_speed,
+                                                                   d_instantaneous_thrust,
+                                                                   d_instantaneous_power,
+                                                                   d_instantaneous_efficiency,
+                                                                   d_adapted_amplitude,
+                                                                   d_adapted_frequency };
+    if (d_cycle_statistics.addSample(time, dt, d_adapted_frequency, cycle_sample)) writeCycleStatistics();
+
+    // Write performance metrics periodically
+    const double write_interval = 0.1; // Write every 0.1 time units
+    if (time - d_last_performance_write_time >= write_interval || d_last_performance_write_time < 0.0)
+    {
+        writePerformanceMetrics(time);
+        d_last_performance_write_time = time;
+    }
+
+    IBAMR_TIMER_STOP(t_update_performance_metrics);
+    return;
+} // updatePerformanceMetrics
+
+void
+IBEELKinematics::writePerformanceMetrics(const double time)
+{
+    if (!d_track_performance || !d_performance_writer.isOpen()) return;
+
+    // Queue the row; it is formatted and written by the writer thread.
+    const double row[NUM_PERFORMANCE_COLUMNS] = { time,
+                                                  d_adapted_amplitude,
+                                                  d_adapted_frequency,
+                                                  d_swimming_speed,
+                                                  d_instantaneous_thrust,
+                                                  d_instantaneous_power,
+                                                  d_instantaneous_efficiency };
+    d_performance_writer.append(row);
+
+    return;
+} // writePerformanceMetrics
+
+void
+IBEELKinematics::writeCycleStatistics()
+{
+    if (!d_cycle_writer.isOpen()) return;
+
+    const CycleStatistics& stats = d_cycle_statistics;
+    const double row[NUM_CYCLE_COLUMNS] = {
+        stats.getCompletedCycleEndTime(),
+        static_cast<double>(stats.getNumberOfCompletedCycles()),
+        stats.getCompletedCycleStartTime(),
+        stats.getCompletedCycle(CycleStatistics::SWIMMING_SPEED).getMean(),
+        stats.getCompletedCycle(CycleStatistics::SWIMMING_SPEED).getStandardDeviation(),
+        stats.getCompletedCycle(CycleStatistics::THRUST).getMean(),
+        stats.getCompletedCycle(CycleStatistics::THRUST).getStandardDeviation(),
+        stats.getCompletedCycle(CycleStatistics::POWER).getMean(),
+        stats.getCompletedCycle(CycleStatistics::POWER).getStandardDeviation(),
+        stats.getCompletedCycle(CycleStatistics::EFFICIENCY).getMean(),
+        stats.getCompletedCycle(CycleStatistics::EFFICIENCY).getStandardDeviation(),
+        stats.getCompletedCycle(CycleStatistics::AMPLITUDE).getMean(),
+        stats.getCompletedCycle(CycleStatistics::FREQUENCY).getMean(),
+        stats.getCompletedCycleStrouhalNumber()
+    };
+    d_cycle_writer.append(row);
+
+    return;
+} // writeCycleStatistics
+
+void
+IBEELKinematics::updateSchoolDeformation(const std::vector<IBEELKinematics*>& swimmers, const double time)
+{
+    IBAMR_TIMER_START(t_update_school_deformation);
 
-        // Calculate Froude efficiency: eta = (Thrust * Speed) / Power
-        double efficiency = 0.0;
-        if (std::abs(d_instantaneous_power) > 1e-10)
+    int num_workers = 1;
+    for (std::size_t i = 0; i < swimmers.size(); ++i)
+    {
+        num_workers = std::max(num_workers, swimmers[i]->d_kinematics.getNumberOfWorkers());
+    }
+    num_workers = std::min(num_workers, static_cast<int>(swimmers.size()));
+
+    // Each swimmer only touches its own state. Nested regions are serialized, which does not change the
+    // per-section results.
+    const int num_swimmers = static_cast<int>(swimmers.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(num_workers) if (num_workers > 1)
+#endif
+    for (int i = 0; i < num_swimmers; ++i)
+    {
+        EelKinematics& kinematics = swimmers[i]->d_kinematics;
+        if (kinematics.getKinematicsType() != EelKinematics::PARSER_KINEMATICS)
         {
-            efficiency = (d_instantaneous_thrust * d_swimming_speed) / d_instantaneous_power;
+            kinematics.updateSectionDeformation(time);
         }
+    }
 
-        outfile << std::scientific << std::setprecision(8)
-                << time << " "
-                << d_adapted_amplitude << " "
-                << d_adapted_frequency << " "
-                << d_swimming_speed << " "
-                << d_instantaneous_thrust << " "
-                << d_instantaneous_power << " "
-                << efficiency << std::endl;
+    IBAMR_TIMER_STOP(t_update_school_deformation);
+    return;
+} // updateSchoolDeformation
 
-        outfile.close();
+void
+IBEELKinematics::checkShapeCache()
+{
+    double error, time;
+    if (d_kinematics.checkShapeCacheFailed(error, time))
+    {
+        TBOX_WARNING(d_object_name << "::checkShapeCache() :\n"
+                                   << "  shape cache error " << error << " at time " << time
+                                   << " exceeds shape_cache_tolerance; is the deformation periodic with period "
+                                   << d_kinematics.getShapeCachePeriod() << "?" << std::endl);
     }
+    return;
+} // checkShapeCache
+
+void
+IBEELKinematics::checkStepAllocations(const char* caller, const unsigned long long start_count) const
+{
+    if (!d_check_step_allocations) return;
 
+    const unsigned long long num_allocations = AllocationCounter::getCount() - start_count;
+    if (num_allocations > 0)
+    {
+        TBOX_ERROR("IBEELKinematics::" << caller << " :\n"
+                                       << "  " << num_allocations << " heap allocation(s) made during the kinematics "
+                                       << "update at time " << d_new_time << "." << std::endl);
+    }
     return;
-} // writePerformanceMetrics
+} // checkStepAllocations
 
 } // namespace IBAMR
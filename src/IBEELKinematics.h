@@ -18,6 +18,10 @@
 
 #include <ibamr/ConstraintIBKinematics.h>
 
+#include "CycleStatistics.h"
+#include "EelKinematics.h"
+#include "PerformanceMetricsWriter.h"
+
 #include <ibtk/LDataManager.h>
 #include <ibtk/ibtk_utilities.h>
 
@@ -28,7 +32,6 @@
 #include <tbox/Pointer.h>
 
 #include <iostream>
-#include <map>
 #include <string>
 #include <vector>
 
@@ -94,112 +97,140 @@ public:
      */
     virtual void putToDatabase(SAMRAI::tbox::Pointer<SAMRAI::tbox::Database> db);
 
-private:
     /*!
-     * \brief Copy constructor (not implemented).
+     * \brief Compute the thrust, power and swimming speed from the Lagrangian constraint forces at the end of
+     * a time step, and log them with the performance metrics. Must be called on all ranks.
+     *
+     * The constraint force that ConstraintIBMethod exerts on the fluid at each Lagrangian point is
+     * rho*U_correction*dV/dt. The thrust is the sum of the hydrodynamic forces on the body points that push it
+     * along the swimming direction, and the power is the rate of work done on the fluid by the deformation
+     * velocity. Each rank sums over its local points and the partial sums are reduced once.
      */
-    IBEELKinematics(const IBEELKinematics& from);
+    void updatePerformanceMetrics(const double time,
+                                  const double dt,
+                                  const double rho,
+                                  const std::vector<double>& com_velocity);
 
     /*!
-     * \brief Assignment operator (not implemented).
+     * \brief Evaluate the body-frame deformation of several swimmers at the given time in one pass, threaded
+     * over the swimmers.
+     *
+     * Call this with the new time before advancing the hierarchy: the subsequent setKinematicsVelocity() and
+     * setShape() calls of each swimmer at that time then reuse the deformation instead of evaluating it
+     * swimmer by swimmer. Swimmers with PARSER kinematics evaluate their shape pointwise and are skipped.
      */
-    IBEELKinematics& operator=(const IBEELKinematics& that);
+    static void updateSchoolDeformation(const std::vector<IBEELKinematics*>& swimmers, const double time);
 
     /*!
-     * \brief Read object state from restart file.
+     * \brief Whether the performance metrics and their cycle statistics are computed (track_performance).
      */
-    void getFromRestart();
+    bool isTrackingPerformance() const
+    {
+        return d_track_performance;
+    }
 
     /*!
-     * \brief Set immersed body layout.
+     * \brief Name of the file the performance metrics are logged to.
      */
-    void setImmersedBodyLayout(SAMRAI::tbox::Pointer<SAMRAI::hier::PatchHierarchy<NDIM> > patch_hierarchy);
+    const std::string& getPerformanceLogFile() const
+    {
+        return d_performance_log_file;
+    }
 
     /*!
-     * \brief Set eel specific velocity.
+     * \brief Statistics of the performance metrics over the tail-beat cycles; the same on all ranks.
      */
-    void setEelSpecificVelocity(const double time,
-                               const std::vector<double>& incremented_angle_from_reference_axis,
-                               const std::vector<double>& center_of_mass,
-                               const std::vector<double>& tagged_pt_position);
+    const CycleStatistics& getCycleStatistics() const
+    {
+        return d_cycle_statistics;
+    }
 
     /*!
-     * \brief Transform maneuver axis and calculate tangents.
+     * \brief Volume represented by each Lagrangian point of the body.
      */
-    void transformManeuverAxisAndCalculateTangents(const double angleFromHorizontal);
+    double getVolumeElement() const
+    {
+        const double* const mesh_width = d_kinematics.getMeshWidth();
+        double dV = 1.0;
+        for (int d = 0; d < NDIM; ++d) dV *= mesh_width[d];
+        return dV;
+    }
 
+private:
     /*!
-     * \brief Calculate adaptive kinematics parameters based on Reynolds number.
+     * \brief Copy constructor (not implemented).
      */
-    void calculateAdaptiveKinematics(const double time);
+    IBEELKinematics(const IBEELKinematics& from);
 
     /*!
-     * \brief Write performance metrics to file.
+     * \brief Assignment operator (not implemented).
      */
-    void writePerformanceMetrics(const double time);
+    IBEELKinematics& operator=(const IBEELKinematics& that);
 
     /*!
-     * Current time (t) and new time (t+dt).
+     * \brief Read object state from restart file.
      */
-    double d_current_time, d_new_time;
+    void getFromRestart();
 
     /*!
-     * Deformation velocity and shape of the body.
+     * \brief Lay out the body for the mesh width of the finest level.
      */
-    std::vector<std::vector<double> > d_kinematics_vel;
-    std::vector<std::vector<double> > d_shape;
+    void setImmersedBodyLayout(SAMRAI::tbox::Pointer<SAMRAI::hier::PatchHierarchy<NDIM> > patch_hierarchy);
 
     /*!
-     * Center of mass, tagged point position, and incremented rotation angle.
+     * \brief Create muParser instances for every worker of the kinematics core, for the functions that could
+     * not be compiled.
      */
-    std::vector<double> d_center_of_mass, d_incremented_angle_from_reference_axis, d_tagged_pt_position;
+    void createFallbackParsers();
 
     /*!
-     * Background mesh data.
+     * \brief Calculate adaptive kinematics parameters based on Reynolds number.
      */
-    SAMRAI::tbox::Array<double> d_mesh_width;
+    void calculateAdaptiveKinematics(const double time);
 
     /*!
-     * Parser variables.
+     * \brief Write performance metrics to file.
      */
-    std::array<double, NDIM> d_parser_posn;
-    std::array<double, NDIM> d_parser_normal;
-    double d_parser_time;
+    void writePerformanceMetrics(const double time);
 
     /*!
-     * Parsers for deformation velocity, body shape, and maneuvering axis.
+     * \brief Write the statistics of the cycle just completed to the cycle statistics file.
      */
-    std::vector<mu::Parser*> d_deformationvel_parsers;
-    std::vector<mu::Parser*> d_all_parsers;
-    mu::Parser* d_body_shape_parser;
-    mu::Parser* d_maneuvering_axis_parser;
+    void writeCycleStatistics();
 
     /*!
-     * Body kinematics flags.
+     * \brief Warn if a runtime check of the shape cache failed during the last kinematics update. The warning
+     * allocates, so this is called after checkStepAllocations().
      */
-    bool d_bodyIsManeuvering;
-    bool d_maneuverAxisIsChangingShape;
-    double d_initAngle_bodyAxis_x;
+    void checkShapeCache();
 
     /*!
-     * Immersed body data: map from s-coordinate to number of points.
+     * \brief Abort if heap allocations were made since the given allocation count, when step allocation
+     * checking is enabled.
      */
-    std::map<double, int> d_ImmersedBodyData;
+    void checkStepAllocations(const char* caller, const unsigned long long start_count) const;
 
     /*!
-     * Maneuvering axis coordinates and tangent data.
+     * Lagrangian data of the structure.
      */
-    std::vector<std::vector<double> > d_maneuverAxisReferenceCoordinates_vec;
-    std::vector<std::vector<double> > d_maneuverAxisTransformedCoordinates_vec;
-    std::map<double, double> d_map_reference_tangent;
-    std::map<double, double> d_map_transformed_tangent;
-    std::map<double, std::vector<int> > d_map_reference_sign;
-    std::map<double, std::vector<int> > d_map_transformed_sign;
+    IBTK::LDataManager* d_l_data_manager;
 
     /*!
-     * Food location (for adaptive maneuvering).
+     * Current time (t) and new time (t+dt).
      */
-    SAMRAI::tbox::Array<double> d_food_location;
+    double d_current_time, d_new_time;
+
+    /*!
+     * Center of mass, tagged point position, and incremented rotation angle.
+     */
+    std::vector<double> d_center_of_mass, d_incremented_angle_from_reference_axis, d_tagged_pt_position;
+
+    /*!
+     * Body layout, maneuvering axis, deformation velocity and shape, evaluated independently of IBAMR, and
+     * the muParser instances it falls back on for the expressions that could not be compiled.
+     */
+    EelKinematics d_kinematics;
+    std::vector<mu::Parser*> d_all_parsers;
 
     /*!
      * Reynolds number and thickness parameters for adaptive kinematics.
@@ -217,6 +248,7 @@ private:
     double d_adapted_frequency;
     double d_adapted_wavelength;
     double d_envelope_power;           // Power for amplitude envelope
+    double d_last_adaptation_log_time; // Time the adapted parameters were last logged
 
     /*!
      * Performance metrics tracking.
@@ -225,7 +257,27 @@ private:
     std::string d_performance_log_file;
     double d_instantaneous_thrust;
     double d_instantaneous_power;
+    double d_instantaneous_efficiency;
     double d_swimming_speed;
+    double d_last_performance_write_time;
+
+    /*!
+     * Background writer of the performance metrics (rank 0 only), and the number of buffered rows and the
+     * wall-clock interval in seconds after which it writes them out.
+     */
+    static const int NUM_PERFORMANCE_COLUMNS = 7;
+    PerformanceMetricsWriter d_performance_writer;
+    int d_performance_flush_rows;
+    double d_performance_flush_interval;
+
+    /*!
+     * Time-weighted statistics of the performance metrics over each tail-beat cycle, and the writer of the
+     * summary row of each completed cycle (rank 0 only).
+     */
+    static const int NUM_CYCLE_COLUMNS = 14;
+    CycleStatistics d_cycle_statistics;
+    std::string d_cycle_statistics_file;
+    PerformanceMetricsWriter d_cycle_writer;
 
     /*!
      * Shape adaptation parameters.
@@ -234,6 +286,12 @@ private:
     double d_head_width_ratio;         // Ratio of head width to body length
     double d_tail_width_ratio;         // Ratio of tail width (for carangiform)
 
+    /*!
+     * Whether the kinematics update of each step is checked to make no heap allocations (requires a build
+     * with EEL2D_COUNT_ALLOCATIONS=ON).
+     */
+    bool d_check_step_allocations;
+
 }; // IBEELKinematics
 
 } // namespace IBAMR
@@ -0,0 +1,831 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+//////////////////////////// INCLUDES /////////////////////////////////////////
+
+#include "KinematicsExpression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace IBAMR
+{
+namespace
+{
+static const double PII = 3.1415926535897932384626433832795;
+static const double EULER = 2.7182818284590452353602874713527;
+
+inline double
+valueOf(const double a)
+{
+    return a;
+}
+
+inline double
+valueOf(const DualNumber& a)
+{
+    return a.val;
+}
+
+inline double
+signOf(const double a)
+{
+    return (a > 0) ? 1.0 : ((a < 0) ? -1.0 : 0.0);
+}
+
+inline DualNumber
+signOf(const DualNumber& a)
+{
+    return DualNumber(signOf(a.val));
+}
+
+inline double
+rintOf(const double a)
+{
+    return std::rint(a);
+}
+
+inline DualNumber
+rintOf(const DualNumber& a)
+{
+    return DualNumber(std::rint(a.val));
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////
+
+const int KinematicsExpression::MAX_STACK_DEPTH;
+const int KinematicsExpression::BATCH_SIZE;
+
+KinematicsExpression::KinematicsExpression()
+    : d_expression("0"),
+      d_dim(0),
+      d_has_jumps(false),
+      d_pos(0),
+      d_stack_depth(0),
+      d_max_stack_depth(1),
+      d_fold_barrier(0)
+{
+    Instruction zero = { PUSH_CONSTANT, 0, 0.0 };
+    d_program.push_back(zero);
+    return;
+} // KinematicsExpression
+
+KinematicsExpression::KinematicsExpression(const std::string& expression,
+                                           const int dim,
+                                           const std::vector<std::string>& constant_names)
+    : d_expression(expression),
+      d_dim(dim),
+      d_constant_names(constant_names),
+      d_has_jumps(false),
+      d_pos(0),
+      d_stack_depth(0),
+      d_max_stack_depth(0),
+      d_fold_barrier(0)
+{
+    if (dim > KinematicsEvaluationContext::MAX_DIM) error("spatial dimension is too large");
+    parseTernary();
+    skipWhitespace();
+    if (d_pos != d_expression.size()) error("unexpected token");
+    for (std::vector<Instruction>::const_iterator it = d_program.begin(); it != d_program.end(); ++it)
+    {
+        if (it->op == JUMP_IF_ZERO || it->op == JUMP) d_has_jumps = true;
+    }
+    return;
+} // KinematicsExpression
+
+double
+KinematicsExpression::evaluate(const KinematicsEvaluationContext& context) const
+{
+    return execute<double>(
+        d_program, context.time, context.posn.data(), context.normal.data(), context.constants.data());
+} // evaluate
+
+DualNumber
+KinematicsExpression::evaluateWithTimeDerivative(const KinematicsEvaluationContext& context) const
+{
+    return execute<DualNumber>(d_program,
+                               DualNumber(context.time, 1.0),
+                               context.posn.data(),
+                               context.normal.data(),
+                               context.constants.data());
+} // evaluateWithTimeDerivative
+
+void
+KinematicsExpression::evaluate(const KinematicsEvaluationContext& context,
+                               const int num_points,
+                               const double* const* posn,
+                               const double* const* normal,
+                               double* values) const
+{
+    executeBatch<double>(context.time, context, num_points, posn, normal, values);
+    return;
+} // evaluate
+
+void
+KinematicsExpression::evaluateWithTimeDerivative(const KinematicsEvaluationContext& context,
+                                                 const int num_points,
+                                                 const double* const* posn,
+                                                 const double* const* normal,
+                                                 double* values,
+                                                 double* time_derivatives) const
+{
+    DualNumber block[BATCH_SIZE];
+    for (int begin = 0; begin < num_points; begin += BATCH_SIZE)
+    {
+        const int n = std::min(BATCH_SIZE, num_points - begin);
+        const double* block_posn[KinematicsEvaluationContext::MAX_DIM] = { nullptr };
+        const double* block_normal[KinematicsEvaluationContext::MAX_DIM] = { nullptr };
+        for (int d = 0; d < d_dim; ++d)
+        {
+            if (posn && posn[d]) block_posn[d] = posn[d] + begin;
+            if (normal && normal[d]) block_normal[d] = normal[d] + begin;
+        }
+        executeBatch<DualNumber>(DualNumber(context.time, 1.0), context, n, block_posn, block_normal, block);
+        for (int l = 0; l < n; ++l)
+        {
+            values[begin + l] = block[l].val;
+            time_derivatives[begin + l] = block[l].der;
+        }
+    }
+    return;
+} // evaluateWithTimeDerivative
+
+template <class Scalar>
+Scalar
+KinematicsExpression::applyBinary(const OpCode op, const Scalar& a, const Scalar& b)
+{
+    using std::pow;
+
+    switch (op)
+    {
+    case ADD:
+        return a + b;
+    case SUBTRACT:
+        return a - b;
+    case MULTIPLY:
+        return a * b;
+    case DIVIDE:
+        return a / b;
+    case POWER:
+        return pow(a, b);
+    case LESS:
+        return Scalar(valueOf(a) < valueOf(b) ? 1.0 : 0.0);
+    case LESS_EQUAL:
+        return Scalar(valueOf(a) <= valueOf(b) ? 1.0 : 0.0);
+    case GREATER:
+        return Scalar(valueOf(a) > valueOf(b) ? 1.0 : 0.0);
+    case GREATER_EQUAL:
+        return Scalar(valueOf(a) >= valueOf(b) ? 1.0 : 0.0);
+    case EQUAL:
+        return Scalar(valueOf(a) == valueOf(b) ? 1.0 : 0.0);
+    case NOT_EQUAL:
+        return Scalar(valueOf(a) != valueOf(b) ? 1.0 : 0.0);
+    case LOGICAL_AND:
+        return Scalar((valueOf(a) != 0.0 && valueOf(b) != 0.0) ? 1.0 : 0.0);
+    case LOGICAL_OR:
+        return Scalar((valueOf(a) != 0.0 || valueOf(b) != 0.0) ? 1.0 : 0.0);
+    default:
+        return a;
+    }
+} // applyBinary
+
+template <class Scalar>
+Scalar
+KinematicsExpression::applyFunction(const Function f, const Scalar& a)
+{
+    using std::abs;
+    using std::acos;
+    using std::asin;
+    using std::atan;
+    using std::cos;
+    using std::cosh;
+    using std::exp;
+    using std::log;
+    using std::log10;
+    using std::log2;
+    using std::sin;
+    using std::sinh;
+    using std::sqrt;
+    using std::tan;
+    using std::tanh;
+
+    switch (f)
+    {
+    case SIN:
+        return sin(a);
+    case COS:
+        return cos(a);
+    case TAN:
+        return tan(a);
+    case ASIN:
+        return asin(a);
+    case ACOS:
+        return acos(a);
+    case ATAN:
+        return atan(a);
+    case SINH:
+        return sinh(a);
+    case COSH:
+        return cosh(a);
+    case TANH:
+        return tanh(a);
+    case EXP:
+        return exp(a);
+    case LOG:
+        return log(a);
+    case LOG10:
+        return log10(a);
+    case LOG2:
+        return log2(a);
+    case SQRT:
+        return sqrt(a);
+    case ABS:
+        return abs(a);
+    case SIGN:
+        return signOf(a);
+    case RINT:
+        return rintOf(a);
+    }
+    return a;
+} // applyFunction
+
+template <class Scalar>
+Scalar
+KinematicsExpression::accumulate(const OpCode op, const Scalar& result, const Scalar& a)
+{
+    if (op == MIN) return (valueOf(a) < valueOf(result)) ? a : result;
+    if (op == MAX) return (valueOf(result) < valueOf(a)) ? a : result;
+    return result + a;
+} // accumulate
+
+template <class Scalar>
+Scalar
+KinematicsExpression::execute(const std::vector<Instruction>& program,
+                              const Scalar& time,
+                              const double* posn,
+                              const double* normal,
+                              const double* constants)
+{
+    // The stack lives on the call stack so that concurrent evaluations never share state.
+    Scalar stack[MAX_STACK_DEPTH];
+    int top = -1;
+    const int program_size = static_cast<int>(program.size());
+    for (int pc = 0; pc < program_size; ++pc)
+    {
+        const Instruction& ins = program[pc];
+        switch (ins.op)
+        {
+        case PUSH_CONSTANT:
+            stack[++top] = Scalar(ins.value);
+            break;
+        case PUSH_TIME:
+            stack[++top] = time;
+            break;
+        case PUSH_POSITION:
+            stack[++top] = Scalar(posn[ins.arg]);
+            break;
+        case PUSH_NORMAL:
+            stack[++top] = Scalar(normal[ins.arg]);
+            break;
+        case PUSH_USER_CONSTANT:
+            stack[++top] = Scalar(constants[ins.arg]);
+            break;
+        case NEGATE:
+            stack[top] = -stack[top];
+            break;
+        case JUMP_IF_ZERO:
+            if (valueOf(stack[top--]) == 0.0) pc = ins.arg - 1;
+            break;
+        case JUMP:
+            pc = ins.arg - 1;
+            break;
+        case FUNCTION:
+            stack[top] = applyFunction(static_cast<Function>(ins.arg), stack[top]);
+            break;
+        case MIN:
+        case MAX:
+        case SUM:
+        case AVG:
+        {
+            const int first = top - ins.arg + 1;
+            Scalar result = stack[first];
+            for (int i = first + 1; i <= top; ++i) result = accumulate(ins.op, result, stack[i]);
+            if (ins.op == AVG) result = result / Scalar(static_cast<double>(ins.arg));
+            top = first;
+            stack[top] = result;
+            break;
+        }
+        default:
+            --top;
+            stack[top] = applyBinary(ins.op, stack[top], stack[top + 1]);
+            break;
+        }
+    }
+
+    return stack[0];
+} // execute
+
+template <class Scalar>
+void
+KinematicsExpression::executeBatch(const Scalar& time,
+                                   const KinematicsEvaluationContext& context,
+                                   const int num_points,
+                                   const double* const* posn,
+                                   const double* const* normal,
+                                   Scalar* values) const
+{
+    const double* const constants = context.constants.data();
+
+    // Branches may take different paths at different points, so programs with jumps run point by point.
+    if (d_has_jumps)
+    {
+        std::array<double, KinematicsEvaluationContext::MAX_DIM> point_posn = context.posn;
+        std::array<double, KinematicsEvaluationContext::MAX_DIM> point_normal = context.normal;
+        for (int i = 0; i < num_points; ++i)
+        {
+            for (int d = 0; d < d_dim; ++d)
+            {
+                if (posn && posn[d]) point_posn[d] = posn[d][i];
+                if (normal && normal[d]) point_normal[d] = normal[d][i];
+            }
+            values[i] = execute<Scalar>(d_program, time, point_posn.data(), point_normal.data(), constants);
+        }
+        return;
+    }
+
+    // Otherwise each instruction is applied to a whole block of points before moving on to the next one.
+    Scalar stack[MAX_STACK_DEPTH][BATCH_SIZE];
+    const int program_size = static_cast<int>(d_program.size());
+    for (int begin = 0; begin < num_points; begin += BATCH_SIZE)
+    {
+        const int n = std::min(BATCH_SIZE, num_points - begin);
+        int top = -1;
+        for (int pc = 0; pc < program_size; ++pc)
+        {
+            const Instruction& ins = d_program[pc];
+            switch (ins.op)
+            {
+            case PUSH_CONSTANT:
+                ++top;
+                for (int l = 0; l < n; ++l) stack[top][l] = Scalar(ins.value);
+                break;
+            case PUSH_TIME:
+                ++top;
+                for (int l = 0; l < n; ++l) stack[top][l] = time;
+                break;
+            case PUSH_POSITION:
+            case PUSH_NORMAL:
+            {
+                ++top;
+                const bool is_posn = ins.op == PUSH_POSITION;
+                const double* const* points = is_posn ? posn : normal;
+                const double* const component = points ? points[ins.arg] : nullptr;
+                if (component)
+                {
+                    for (int l = 0; l < n; ++l) stack[top][l] = Scalar(component[begin + l]);
+                }
+                else
+                {
+                    const double value = is_posn ? context.posn[ins.arg] : context.normal[ins.arg];
+                    for (int l = 0; l < n; ++l) stack[top][l] = Scalar(value);
+                }
+                break;
+            }
+            case PUSH_USER_CONSTANT:
+                ++top;
+                for (int l = 0; l < n; ++l) stack[top][l] = Scalar(constants[ins.arg]);
+                break;
+            case NEGATE:
+                for (int l = 0; l < n; ++l) stack[top][l] = -stack[top][l];
+                break;
+            case ADD:
+                --top;
+                for (int l = 0; l < n; ++l) stack[top][l] = stack[top][l] + stack[top + 1][l];
+                break;
+            case SUBTRACT:
+                --top;
+                for (int l = 0; l < n; ++l) stack[top][l] = stack[top][l] - stack[top + 1][l];
+                break;
+            case MULTIPLY:
+                --top;
+                for (int l = 0; l < n; ++l) stack[top][l] = stack[top][l] * stack[top + 1][l];
+                break;
+            case DIVIDE:
+                --top;
+                for (int l = 0; l < n; ++l) stack[top][l] = stack[top][l] / stack[top + 1][l];
+                break;
+            case FUNCTION:
+            {
+                const Function f = static_cast<Function>(ins.arg);
+                for (int l = 0; l < n; ++l) stack[top][l] = applyFunction(f, stack[top][l]);
+                break;
+            }
+            case MIN:
+            case MAX:
+            case SUM:
+            case AVG:
+            {
+                const int first = top - ins.arg + 1;
+                for (int l = 0; l < n; ++l)
+                {
+                    Scalar result = stack[first][l];
+                    for (int i = first + 1; i <= top; ++i) result = accumulate(ins.op, result, stack[i][l]);
+                    if (ins.op == AVG) result = result / Scalar(static_cast<double>(ins.arg));
+                    stack[first][l] = result;
+                }
+                top = first;
+                break;
+            }
+            default:
+                --top;
+                for (int l = 0; l < n; ++l) stack[top][l] = applyBinary(ins.op, stack[top][l], stack[top + 1][l]);
+                break;
+            }
+        }
+
+        for (int l = 0; l < n; ++l) values[begin + l] = stack[0][l];
+    }
+
+    return;
+} // executeBatch
+
+void
+KinematicsExpression::parseTernary()
+{
+    parseLogicalOr();
+    if (!accept("?")) return;
+
+    // cond ? a : b is compiled to: cond JUMP_IF_ZERO(else) a JUMP(end) else: b end:
+    const std::size_t jump_to_else = d_program.size();
+    emit(JUMP_IF_ZERO);
+    parseTernary();
+    expect(":");
+    const std::size_t jump_to_end = d_program.size();
+    emit(JUMP);
+    d_program[jump_to_else].arg = static_cast<int>(d_program.size());
+    updateStackDepth(-1);
+    parseTernary();
+    d_program[jump_to_end].arg = static_cast<int>(d_program.size());
+
+    // Constants on either side of the branch must never be folded together.
+    d_fold_barrier = d_program.size();
+    return;
+} // parseTernary
+
+void
+KinematicsExpression::parseLogicalOr()
+{
+    parseLogicalAnd();
+    while (accept("||"))
+    {
+        parseLogicalAnd();
+        emit(LOGICAL_OR, 0, 0.0, 2);
+    }
+    return;
+} // parseLogicalOr
+
+void
+KinematicsExpression::parseLogicalAnd()
+{
+    parseComparison();
+    while (accept("&&"))
+    {
+        parseComparison();
+        emit(LOGICAL_AND, 0, 0.0, 2);
+    }
+    return;
+} // parseLogicalAnd
+
+void
+KinematicsExpression::parseComparison()
+{
+    parseAdditive();
+    while (true)
+    {
+        OpCode op;
+        if (accept("<="))
+            op = LESS_EQUAL;
+        else if (accept(">="))
+            op = GREATER_EQUAL;
+        else if (accept("=="))
+            op = EQUAL;
+        else if (accept("!="))
+            op = NOT_EQUAL;
+        else if (accept("<"))
+            op = LESS;
+        else if (accept(">"))
+            op = GREATER;
+        else
+            return;
+        parseAdditive();
+        emit(op, 0, 0.0, 2);
+    }
+} // parseComparison
+
+void
+KinematicsExpression::parseAdditive()
+{
+    parseMultiplicative();
+    while (true)
+    {
+        if (accept("+"))
+        {
+            parseMultiplicative();
+            emit(ADD, 0, 0.0, 2);
+        }
+        else if (accept("-"))
+        {
+            parseMultiplicative();
+            emit(SUBTRACT, 0, 0.0, 2);
+        }
+        else
+        {
+            return;
+        }
+    }
+} // parseAdditive
+
+void
+KinematicsExpression::parseMultiplicative()
+{
+    parseUnary();
+    while (true)
+    {
+        if (accept("*"))
+        {
+            parseUnary();
+            emit(MULTIPLY, 0, 0.0, 2);
+        }
+        else if (accept("/"))
+        {
+            parseUnary();
+            emit(DIVIDE, 0, 0.0, 2);
+        }
+        else
+        {
+            return;
+        }
+    }
+} // parseMultiplicative
+
+void
+KinematicsExpression::parseUnary()
+{
+    // As in muParser, the sign binds weaker than ^, i.e. -2^2 = -4.
+    if (accept("-"))
+    {
+        parseUnary();
+        emit(NEGATE, 0, 0.0, 1);
+    }
+    else if (accept("+"))
+    {
+        parseUnary();
+    }
+    else
+    {
+        parsePower();
+    }
+    return;
+} // parseUnary
+
+void
+KinematicsExpression::parsePower()
+{
+    parsePrimary();
+    if (accept("^"))
+    {
+        // Right associative: a^b^c = a^(b^c).
+        parseUnary();
+        emit(POWER, 0, 0.0, 2);
+    }
+    return;
+} // parsePower
+
+void
+KinematicsExpression::parsePrimary()
+{
+    skipWhitespace();
+    if (d_pos >= d_expression.size()) error("unexpected end of expression");
+
+    const char c = d_expression[d_pos];
+    if (accept("("))
+    {
+        parseTernary();
+        expect(")");
+    }
+    else if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+    {
+        const char* const begin = d_expression.c_str() + d_pos;
+        char* end = nullptr;
+        const double value = std::strtod(begin, &end);
+        if (end == begin) error("invalid number");
+        d_pos += end - begin;
+        emit(PUSH_CONSTANT, 0, value);
+    }
+    else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+    {
+        const std::string::size_type begin = d_pos;
+        while (d_pos < d_expression.size() &&
+               (std::isalnum(static_cast<unsigned char>(d_expression[d_pos])) || d_expression[d_pos] == '_'))
+        {
+            ++d_pos;
+        }
+        parseIdentifier(d_expression.substr(begin, d_pos - begin));
+    }
+    else
+    {
+        error("unexpected token");
+    }
+    return;
+} // parsePrimary
+
+void
+KinematicsExpression::parseIdentifier(const std::string& name)
+{
+    // Function call.
+    if (accept("("))
+    {
+        static const char* const function_names[] = { "sin",  "cos",  "tan",  "asin", "acos",  "atan",
+                                                       "sinh", "cosh", "tanh", "exp",  "log",   "log10",
+                                                       "log2", "sqrt", "abs",  "sign", "rint" };
+        static const int num_functions = sizeof(function_names) / sizeof(function_names[0]);
+        for (int f = 0; f < num_functions; ++f)
+        {
+            if (name == function_names[f])
+            {
+                parseTernary();
+                expect(")");
+                emit(FUNCTION, f, 0.0, 1);
+                return;
+            }
+        }
+        if (name == "ln")
+        {
+            parseTernary();
+            expect(")");
+            emit(FUNCTION, LOG, 0.0, 1);
+            return;
+        }
+
+        OpCode op;
+        if (name == "min")
+            op = MIN;
+        else if (name == "max")
+            op = MAX;
+        else if (name == "sum")
+            op = SUM;
+        else if (name == "avg")
+            op = AVG;
+        else
+            error("unknown function ``" + name + "''");
+
+        int num_args = 0;
+        do
+        {
+            parseTernary();
+            ++num_args;
+        } while (accept(","));
+        expect(")");
+        emit(op, num_args, 0.0, num_args);
+        return;
+    }
+
+    // Constants.
+    if (name == "pi" || name == "Pi" || name == "PI" || name == "_pi")
+    {
+        emit(PUSH_CONSTANT, 0, PII);
+        return;
+    }
+    if (name == "_e")
+    {
+        emit(PUSH_CONSTANT, 0, EULER);
+        return;
+    }
+
+    // User constants, whose values are supplied by the evaluation context.
+    for (std::size_t k = 0; k < d_constant_names.size(); ++k)
+    {
+        if (name == d_constant_names[k])
+        {
+            emit(PUSH_USER_CONSTANT, static_cast<int>(k));
+            return;
+        }
+    }
+
+    // Time.
+    if (name == "T" || name == "t")
+    {
+        emit(PUSH_TIME);
+        return;
+    }
+
+    // Position and normal components: X0, x0, X_0, x_0, N0, n0, N_0, n_0.
+    if (name.size() >= 2 && (name[0] == 'X' || name[0] == 'x' || name[0] == 'N' || name[0] == 'n'))
+    {
+        const std::string::size_type digits = (name[1] == '_') ? 2 : 1;
+        if (digits < name.size() && name.find_first_not_of("0123456789", digits) == std::string::npos)
+        {
+            const int component = std::atoi(name.c_str() + digits);
+            if (component >= d_dim) error("component of ``" + name + "'' exceeds the spatial dimension");
+            emit((name[0] == 'X' || name[0] == 'x') ? PUSH_POSITION : PUSH_NORMAL, component);
+            return;
+        }
+    }
+
+    error("unknown variable ``" + name + "''");
+    return;
+} // parseIdentifier
+
+void
+KinematicsExpression::skipWhitespace()
+{
+    while (d_pos < d_expression.size() && std::isspace(static_cast<unsigned char>(d_expression[d_pos]))) ++d_pos;
+    return;
+} // skipWhitespace
+
+bool
+KinematicsExpression::accept(const char* token)
+{
+    skipWhitespace();
+    const std::size_t length = std::strlen(token);
+    if (d_expression.compare(d_pos, length, token) != 0) return false;
+    d_pos += length;
+    return true;
+} // accept
+
+void
+KinematicsExpression::expect(const char* token)
+{
+    if (!accept(token)) error(std::string("expected ``") + token + "''");
+    return;
+} // expect
+
+void
+KinematicsExpression::error(const std::string& message) const
+{
+    std::ostringstream os;
+    os << "KinematicsExpression: " << message << " at position " << d_pos << " in ``" << d_expression << "''";
+    throw std::invalid_argument(os.str());
+} // error
+
+void
+KinematicsExpression::emit(const OpCode op, const int arg, const double value, const int num_operands)
+{
+    Instruction ins = { op, arg, value };
+
+    // Fold operations whose operands are all constants.
+    const std::size_t size = d_program.size();
+    bool foldable = op != JUMP_IF_ZERO && op != JUMP && num_operands > 0 &&
+                    size >= d_fold_barrier + static_cast<std::size_t>(num_operands);
+    for (int k = 1; foldable && k <= num_operands; ++k)
+    {
+        foldable = d_program[size - k].op == PUSH_CONSTANT;
+    }
+    if (foldable)
+    {
+        std::vector<Instruction> folded(d_program.end() - num_operands, d_program.end());
+        folded.push_back(ins);
+        const double result = execute<double>(folded, 0.0, nullptr, nullptr, nullptr);
+        d_program.resize(size - num_operands);
+        Instruction constant = { PUSH_CONSTANT, 0, result };
+        d_program.push_back(constant);
+    }
+    else
+    {
+        d_program.push_back(ins);
+    }
+
+    if (op == JUMP_IF_ZERO)
+        updateStackDepth(-1);
+    else if (op != JUMP)
+        updateStackDepth(1 - num_operands);
+    return;
+} // emit
+
+void
+KinematicsExpression::updateStackDepth(const int change)
+{
+    d_stack_depth += change;
+    if (d_stack_depth > d_max_stack_depth) d_max_stack_depth = d_stack_depth;
+    if (d_max_stack_depth > MAX_STACK_DEPTH) error("expression is nested too deeply");
+    return;
+} // updateStackDepth
+
+} // namespace IBAMR
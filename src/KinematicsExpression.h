@@ -0,0 +1,281 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_KinematicsExpression
+#define included_KinematicsExpression
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include "DualNumber.h"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace IBAMR
+{
+/*!
+ * \brief Struct KinematicsEvaluationContext holds the values of the variables of a KinematicsExpression:
+ * time, position, normal and the user constants.
+ *
+ * A compiled expression keeps no evaluation state, so any number of contexts (one per thread, or one per
+ * swimmer) may evaluate the same expression concurrently.
+ */
+struct KinematicsEvaluationContext
+{
+    KinematicsEvaluationContext() : time(0.0)
+    {
+        posn.fill(0.0);
+        normal.fill(0.0);
+    }
+
+    /*!
+     * Maximum spatial dimension of the position and the normal.
+     */
+    static const int MAX_DIM = 3;
+
+    double time;
+    std::array<double, MAX_DIM> posn;
+    std::array<double, MAX_DIM> normal;
+
+    /*!
+     * Values of the user constants, in the order of the names given when the expression was compiled.
+     */
+    std::vector<double> constants;
+};
+
+/*!
+ * \brief Class KinematicsExpression compiles a muParser-style kinematics expression into a compact
+ * stack program that can be evaluated either on doubles or on dual numbers.
+ *
+ * Evaluating on dual numbers seeded with dT/dT = 1 returns the expression together with its exact
+ * partial derivative with respect to time in a single pass, so the deformation velocity of a body
+ * shape y(X,T) never has to be supplied (or kept consistent) separately.
+ *
+ * The recognized syntax is the subset of muParser used for kinematics:
+ *  - variables T/t, X0/x0/X_0/x_0 (position) and N0/n0/N_0/n_0 (normal) for each dimension;
+ *  - constants pi/Pi/PI, floating point literals, and user constants whose values are supplied by the
+ *    evaluation context;
+ *  - operators + - * / ^, unary signs, comparisons, && || and the ternary operator ?: ;
+ *  - functions sin cos tan asin acos atan sinh cosh tanh exp log ln log10 log2 sqrt abs sign rint,
+ *    and min max sum avg with any number of arguments.
+ *
+ * Compilation errors are reported by throwing std::invalid_argument.
+ */
+class KinematicsExpression
+{
+public:
+    /*!
+     * \brief Default constructor (the expression "0").
+     */
+    KinematicsExpression();
+
+    /*!
+     * \brief Compile the given expression for position and normal vectors of dimension dim, with the given
+     * names of user constants.
+     */
+    KinematicsExpression(const std::string& expression,
+                         const int dim,
+                         const std::vector<std::string>& constant_names = std::vector<std::string>());
+
+    /*!
+     * \brief Evaluate the expression.
+     */
+    double evaluate(const KinematicsEvaluationContext& context) const;
+
+    /*!
+     * \brief Evaluate the expression and its partial derivative with respect to time.
+     */
+    DualNumber evaluateWithTimeDerivative(const KinematicsEvaluationContext& context) const;
+
+    /*!
+     * \brief Evaluate the expression at num_points points at once.
+     *
+     * Component d of the position of point i is posn[d][i], or context.posn[d] if posn or posn[d] is null,
+     * and likewise for the normal. Expressions without the ternary operator are evaluated one instruction
+     * at a time over blocks of points, which amortizes the decoding of the program.
+     */
+    void evaluate(const KinematicsEvaluationContext& context,
+                  const int num_points,
+                  const double* const* posn,
+                  const double* const* normal,
+                  double* values) const;
+
+    /*!
+     * \brief Evaluate the expression and its partial derivative with respect to time at num_points points
+     * at once; see evaluate().
+     */
+    void evaluateWithTimeDerivative(const KinematicsEvaluationContext& context,
+                                    const int num_points,
+                                    const double* const* posn,
+                                    const double* const* normal,
+                                    double* values,
+                                    double* time_derivatives) const;
+
+    /*!
+     * \brief Source expression.
+     */
+    const std::string& getExpression() const
+    {
+        return d_expression;
+    }
+
+private:
+    /*!
+     * Operations of the stack program.
+     */
+    enum OpCode
+    {
+        PUSH_CONSTANT,
+        PUSH_TIME,
+        PUSH_POSITION,
+        PUSH_NORMAL,
+        PUSH_USER_CONSTANT,
+        NEGATE,
+        ADD,
+        SUBTRACT,
+        MULTIPLY,
+        DIVIDE,
+        POWER,
+        LESS,
+        LESS_EQUAL,
+        GREATER,
+        GREATER_EQUAL,
+        EQUAL,
+        NOT_EQUAL,
+        LOGICAL_AND,
+        LOGICAL_OR,
+        JUMP_IF_ZERO,
+        JUMP,
+        FUNCTION,
+        MIN,
+        MAX,
+        SUM,
+        AVG
+    };
+
+    /*!
+     * One-argument functions.
+     */
+    enum Function
+    {
+        SIN,
+        COS,
+        TAN,
+        ASIN,
+        ACOS,
+        ATAN,
+        SINH,
+        COSH,
+        TANH,
+        EXP,
+        LOG,
+        LOG10,
+        LOG2,
+        SQRT,
+        ABS,
+        SIGN,
+        RINT
+    };
+
+    struct Instruction
+    {
+        OpCode op;
+        int arg;
+        double value;
+    };
+
+    /*!
+     * Recursive descent parser; each level emits its instructions in postfix order.
+     */
+    void parseTernary();
+    void parseLogicalOr();
+    void parseLogicalAnd();
+    void parseComparison();
+    void parseAdditive();
+    void parseMultiplicative();
+    void parseUnary();
+    void parsePower();
+    void parsePrimary();
+    void parseIdentifier(const std::string& name);
+
+    /*!
+     * Parser helpers.
+     */
+    void skipWhitespace();
+    bool accept(const char* token);
+    void expect(const char* token);
+    void error(const std::string& message) const;
+    void emit(const OpCode op, const int arg = 0, const double value = 0.0, const int num_operands = 0);
+    void updateStackDepth(const int change);
+
+    /*!
+     * Execute a stack program on the given scalar type.
+     */
+    template <class Scalar>
+    static Scalar execute(const std::vector<Instruction>& program,
+                          const Scalar& time,
+                          const double* posn,
+                          const double* normal,
+                          const double* constants);
+
+    /*!
+     * Execute the program at num_points points; see evaluate().
+     */
+    template <class Scalar>
+    void executeBatch(const Scalar& time,
+                      const KinematicsEvaluationContext& context,
+                      const int num_points,
+                      const double* const* posn,
+                      const double* const* normal,
+                      Scalar* values) const;
+
+    /*!
+     * Operations shared by the scalar and the batched execution.
+     */
+    template <class Scalar>
+    static Scalar applyBinary(const OpCode op, const Scalar& a, const Scalar& b);
+    template <class Scalar>
+    static Scalar applyFunction(const Function f, const Scalar& a);
+    template <class Scalar>
+    static Scalar accumulate(const OpCode op, const Scalar& result, const Scalar& a);
+
+    /*!
+     * Maximum depth of the evaluation stack, and number of points per block of the batched execution.
+     */
+    static const int MAX_STACK_DEPTH = 64;
+    static const int BATCH_SIZE = 16;
+
+    std::string d_expression;
+    int d_dim;
+    std::vector<std::string> d_constant_names;
+    std::vector<Instruction> d_program;
+
+    /*!
+     * Whether the program contains jumps, in which case the batched execution runs point by point.
+     */
+    bool d_has_jumps;
+
+    /*!
+     * Parser state: cursor into d_expression, current and maximum stack depth, and the first
+     * instruction that may take part in constant folding.
+     */
+    std::string::size_type d_pos;
+    int d_stack_depth, d_max_stack_depth;
+    std::size_t d_fold_barrier;
+
+}; // KinematicsExpression
+
+} // namespace IBAMR
+
+#endif // #ifndef included_KinematicsExpression
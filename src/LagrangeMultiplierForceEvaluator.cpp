@@ -0,0 +1,232 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+//////////////////////////// INCLUDES /////////////////////////////////////////
+#include "ibtk/IBTK_MPI.h"
+#include "ibtk/LData.h"
+#include "ibtk/LMesh.h"
+#include "ibtk/LNode.h"
+
+#include "LagrangeMultiplierForceEvaluator.h"
+#include "tbox/RestartManager.h"
+#include "tbox/Utilities.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "ibamr/namespaces.h"
+
+namespace IBAMR
+{
+namespace
+{
+// Number of torque components logged per structure.
+static const int TORQUE_DIM = NDIM == 2 ? 1 : 3;
+
+} // namespace
+
+LagrangeMultiplierForceEvaluator::LagrangeMultiplierForceEvaluator(
+    const std::string& object_name,
+    const double rho,
+    const double start_time,
+    const std::vector<std::pair<int, int> >& lag_idx_ranges,
+    const std::vector<double>& vol_elements,
+    const std::string& log_file_name,
+    const bool register_for_restart)
+    : d_object_name(object_name),
+      d_registered_for_restart(register_for_restart),
+      d_rho(rho),
+      d_lag_idx_ranges(lag_idx_ranges),
+      d_vol_elements(vol_elements)
+{
+    const int num_structures = static_cast<int>(d_lag_idx_ranges.size());
+    if (static_cast<int>(d_vol_elements.size()) != num_structures)
+    {
+        TBOX_ERROR(d_object_name << "::LagrangeMultiplierForceEvaluator() :\n"
+                                 << "  " << num_structures << " Lagrangian index ranges but "
+                                 << d_vol_elements.size() << " volume elements" << std::endl);
+    }
+    d_P.assign(num_structures, IBTK::Vector3d::Zero());
+    d_L.assign(num_structures, IBTK::Vector3d::Zero());
+    d_F.assign(num_structures, IBTK::Vector3d::Zero());
+    d_T.assign(num_structures, IBTK::Vector3d::Zero());
+    d_sums.resize(6 * num_structures);
+    d_row.resize(1 + (NDIM + TORQUE_DIM) * num_structures);
+
+    const bool from_restart = RestartManager::getManager()->isFromRestart();
+    if (d_registered_for_restart)
+    {
+        RestartManager::getManager()->registerRestartItem(d_object_name, this);
+        if (from_restart) getFromRestart();
+    }
+
+    if (IBTK_MPI::getRank() == 0)
+    {
+        std::ostringstream header;
+        header << "# Hydrodynamic force and torque on the structures from the Lagrange multipliers\n"
+               << "# Columns: Time";
+        for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+        {
+            for (int d = 0; d < NDIM; ++d) header << ", F" << d << "_" << struct_id;
+            if (NDIM == 2)
+            {
+                header << ", T_" << struct_id;
+            }
+            else
+            {
+                for (int d = 0; d < 3; ++d) header << ", T" << d << "_" << struct_id;
+            }
+        }
+        header << "\n";
+        d_log_writer.open(log_file_name,
+                          header.str(),
+                          static_cast<int>(d_row.size()),
+                          from_restart,
+                          start_time,
+                          /*flush_rows*/ 64,
+                          /*flush_interval*/ 5.0);
+    }
+    return;
+} // LagrangeMultiplierForceEvaluator
+
+LagrangeMultiplierForceEvaluator::~LagrangeMultiplierForceEvaluator()
+{
+    if (d_registered_for_restart) RestartManager::getManager()->unregisterRestartItem(d_object_name);
+    return;
+} // ~LagrangeMultiplierForceEvaluator
+
+void
+LagrangeMultiplierForceEvaluator::computeHydrodynamicForce(
+    LDataManager* l_data_manager,
+    const int ln,
+    const double dt,
+    const std::vector<std::vector<double> >& structure_COM,
+    const std::vector<std::vector<double> >& structure_linear_momentum,
+    const std::vector<std::vector<double> >& structure_rotational_momentum)
+{
+    // Rank-local sums of the constraint forces on the fluid and of their moments about the centers of mass.
+    const int num_structures = static_cast<int>(d_lag_idx_ranges.size());
+    std::fill(d_sums.begin(), d_sums.end(), 0.0);
+    if (l_data_manager->levelContainsLagrangianData(ln))
+    {
+        Pointer<LData> X_data = l_data_manager->getLData("X", ln);
+        Pointer<LData> U_correction_data = l_data_manager->getLData("U_correction", ln);
+        const boost::multi_array_ref<double, 2>& X = *X_data->getLocalFormVecArray();
+        const boost::multi_array_ref<double, 2>& U_correction = *U_correction_data->getLocalFormVecArray();
+        const std::vector<LNode*>& local_nodes = l_data_manager->getLMesh(ln)->getLocalNodes();
+        for (std::vector<LNode*>::const_iterator it = local_nodes.begin(); it != local_nodes.end(); ++it)
+        {
+            const int lag_idx = (*it)->getLagrangianIndex();
+            const int local_idx = (*it)->getLocalPETScIndex();
+            for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+            {
+                const std::pair<int, int>& range = d_lag_idx_ranges[struct_id];
+                if (lag_idx < range.first || lag_idx >= range.second) continue;
+                IBTK::Vector3d f = IBTK::Vector3d::Zero(), r = IBTK::Vector3d::Zero();
+                for (int d = 0; d < NDIM; ++d)
+                {
+                    f[d] = U_correction[local_idx][d] * d_vol_elements[struct_id];
+                    r[d] = X[local_idx][d] - structure_COM[struct_id][d];
+                }
+                const IBTK::Vector3d m = r.cross(f);
+                double* const sums = &d_sums[6 * struct_id];
+                for (int d = 0; d < 3; ++d)
+                {
+                    sums[d] += f[d];
+                    sums[3 + d] += m[d];
+                }
+                break;
+            }
+        }
+        X_data->restoreArrays();
+        U_correction_data->restoreArrays();
+    }
+    IBTK_MPI::sumReduction(d_sums.data(), static_cast<int>(d_sums.size()));
+
+    // The hydrodynamic force is opposite to the constraint force, corrected by the rate of change of the
+    // momentum of the structure.
+    const double force_scale = d_rho / dt;
+    for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+    {
+        IBTK::Vector3d P_new = IBTK::Vector3d::Zero(), L_new = IBTK::Vector3d::Zero();
+        for (int d = 0; d < NDIM; ++d) P_new[d] = structure_linear_momentum[struct_id][d];
+        for (int d = 0; d < 3; ++d) L_new[d] = structure_rotational_momentum[struct_id][d];
+        const double* const sums = &d_sums[6 * struct_id];
+        for (int d = 0; d < 3; ++d)
+        {
+            d_F[struct_id][d] = -force_scale * sums[d] + (P_new[d] - d_P[struct_id][d]) / dt;
+            d_T[struct_id][d] = -force_scale * sums[3 + d] + (L_new[d] - d_L[struct_id][d]) / dt;
+        }
+        d_P[struct_id] = P_new;
+        d_L[struct_id] = L_new;
+    }
+    return;
+} // computeHydrodynamicForce
+
+void
+LagrangeMultiplierForceEvaluator::writeForces(const double time)
+{
+    if (!d_log_writer.isOpen()) return;
+
+    int col = 0;
+    d_row[col++] = time;
+    for (int struct_id = 0; struct_id < static_cast<int>(d_F.size()); ++struct_id)
+    {
+        for (int d = 0; d < NDIM; ++d) d_row[col++] = d_F[struct_id][d];
+        for (int d = 3 - TORQUE_DIM; d < 3; ++d) d_row[col++] = d_T[struct_id][d];
+    }
+    d_log_writer.append(d_row.data());
+    return;
+} // writeForces
+
+void
+LagrangeMultiplierForceEvaluator::putToDatabase(Pointer<Database> db)
+{
+    for (int struct_id = 0; struct_id < static_cast<int>(d_P.size()); ++struct_id)
+    {
+        const std::string id = std::to_string(struct_id);
+        db->putDoubleArray("d_P_" + id, &d_P[struct_id][0], 3);
+        db->putDoubleArray("d_L_" + id, &d_L[struct_id][0], 3);
+    }
+
+    // Make sure that the log covers the state being dumped.
+    d_log_writer.flush();
+
+    return;
+} // putToDatabase
+
+void
+LagrangeMultiplierForceEvaluator::getFromRestart()
+{
+    Pointer<Database> restart_db = RestartManager::getManager()->getRootDatabase();
+    Pointer<Database> db;
+    if (restart_db->isDatabase(d_object_name))
+    {
+        db = restart_db->getDatabase(d_object_name);
+    }
+    else
+    {
+        TBOX_ERROR(d_object_name << ":  Restart database corresponding to " << d_object_name
+                                 << " not found in restart file." << std::endl);
+    }
+
+    for (int struct_id = 0; struct_id < static_cast<int>(d_P.size()); ++struct_id)
+    {
+        const std::string id = std::to_string(struct_id);
+        db->getDoubleArray("d_P_" + id, &d_P[struct_id][0], 3);
+        db->getDoubleArray("d_L_" + id, &d_L[struct_id][0], 3);
+    }
+    return;
+} // getFromRestart
+
+} // namespace IBAMR
@@ -0,0 +1,153 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_LagrangeMultiplierForceEvaluator
+#define included_LagrangeMultiplierForceEvaluator
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include "PerformanceMetricsWriter.h"
+
+#include <ibtk/LDataManager.h>
+#include <ibtk/ibtk_utilities.h>
+
+#include <tbox/Database.h>
+#include <tbox/Pointer.h>
+#include <tbox/Serializable.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace IBAMR
+{
+/*!
+ * \brief Class LagrangeMultiplierForceEvaluator computes the hydrodynamic force and torque on each structure
+ * from the constraint forces of ConstraintIBMethod, at a cost proportional to the number of Lagrangian points.
+ *
+ * The constraint force exerted on the fluid at a Lagrangian point is the Lagrange multiplier
+ * f = rho*U_correction*dV/dt. Part of it accelerates the fluid occupying the body; the rest is the reaction to
+ * the hydrodynamic force. The force and the torque about the center of mass of the fluid on the body are hence
+ *
+ *   F = -sum f + (P^(n+1) - P^n)/dt,   T = -sum (X - X_com) x f + (L^(n+1) - L^n)/dt,
+ *
+ * with P and L the linear and angular momenta of the structure that ConstraintIBMethod computes. Each rank sums
+ * over its local points and the partial sums of all structures are reduced once.
+ *
+ * Rank 0 logs a row per evaluation: the time, then for each structure the NDIM force components and the torque
+ * (its z component in 2D). The momenta of the last evaluation are kept in the restart database, so a restarted
+ * run continues the difference quotients.
+ */
+class LagrangeMultiplierForceEvaluator : public SAMRAI::tbox::Serializable
+{
+public:
+    /*!
+     * \brief Constructor.
+     *
+     * The Lagrangian indices of structure k are lag_idx_ranges[k] and each of its points represents the volume
+     * vol_elements[k]. A run started from restart resumes the log file at start_time.
+     */
+    LagrangeMultiplierForceEvaluator(const std::string& object_name,
+                                     const double rho,
+                                     const double start_time,
+                                     const std::vector<std::pair<int, int> >& lag_idx_ranges,
+                                     const std::vector<double>& vol_elements,
+                                     const std::string& log_file_name,
+                                     const bool register_for_restart = true);
+
+    /*!
+     * \brief Destructor.
+     */
+    ~LagrangeMultiplierForceEvaluator();
+
+    /*!
+     * \brief Compute the force and the torque on each structure over the time step that ended with the current
+     * constraint forces; collective.
+     *
+     * Call this once per time step after the hierarchy has been advanced, with the new centers of mass and
+     * momenta of the structures, which are kept for the next step.
+     */
+    void computeHydrodynamicForce(IBTK::LDataManager* l_data_manager,
+                                  const int ln,
+                                  const double dt,
+                                  const std::vector<std::vector<double> >& structure_COM,
+                                  const std::vector<std::vector<double> >& structure_linear_momentum,
+                                  const std::vector<std::vector<double> >& structure_rotational_momentum);
+
+    /*!
+     * \brief Log the forces and torques of the last evaluation at the given time.
+     */
+    void writeForces(const double time);
+
+    /*!
+     * \brief Force and torque on a structure from the last evaluation.
+     */
+    const IBTK::Vector3d& getForce(const int struct_id) const
+    {
+        return d_F[struct_id];
+    }
+    const IBTK::Vector3d& getTorque(const int struct_id) const
+    {
+        return d_T[struct_id];
+    }
+
+    /*!
+     * \brief Write the momenta of the last evaluation to the restart database.
+     */
+    virtual void putToDatabase(SAMRAI::tbox::Pointer<SAMRAI::tbox::Database> db);
+
+private:
+    /*!
+     * \brief Default constructor (not implemented).
+     */
+    LagrangeMultiplierForceEvaluator();
+
+    /*!
+     * \brief Copy constructor (not implemented).
+     */
+    LagrangeMultiplierForceEvaluator(const LagrangeMultiplierForceEvaluator& from);
+
+    /*!
+     * \brief Assignment operator (not implemented).
+     */
+    LagrangeMultiplierForceEvaluator& operator=(const LagrangeMultiplierForceEvaluator& that);
+
+    /*!
+     * \brief Read the momenta of the last evaluation from the restart database.
+     */
+    void getFromRestart();
+
+    std::string d_object_name;
+    bool d_registered_for_restart;
+    double d_rho;
+    std::vector<std::pair<int, int> > d_lag_idx_ranges;
+    std::vector<double> d_vol_elements;
+
+    /*!
+     * Momenta of the structures at the last evaluation, and the force and torque computed by it.
+     */
+    std::vector<IBTK::Vector3d> d_P, d_L, d_F, d_T;
+
+    /*!
+     * Rank-local sums of the constraint forces and their moments, reduced together.
+     */
+    std::vector<double> d_sums;
+
+    PerformanceMetricsWriter d_log_writer;
+    std::vector<double> d_row;
+
+}; // LagrangeMultiplierForceEvaluator
+
+} // namespace IBAMR
+
+#endif // #ifndef included_LagrangeMultiplierForceEvaluator
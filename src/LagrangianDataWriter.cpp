@@ -0,0 +1,159 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+//////////////////////////// INCLUDES /////////////////////////////////////////
+#include "ibtk/IBTK_MPI.h"
+
+#include "LagrangianDataWriter.h"
+#include "tbox/Utilities.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "ibamr/namespaces.h"
+
+namespace IBAMR
+{
+namespace
+{
+static const char FILE_MAGIC[8] = { 'E', 'E', 'L', '2', 'D', 'L', 'A', 'G' };
+static const int FILE_VERSION = 1;
+static const int HEADER_SIZE = 48;
+
+} // namespace
+
+LagrangianDataWriter::LagrangianDataWriter(const std::string& object_name,
+                                           const std::string& dirname,
+                                           const bool use_single_precision,
+                                           const bool write_deltas,
+                                           const int keyframe_interval)
+    : d_object_name(object_name),
+      d_dirname(dirname),
+      d_use_single_precision(use_single_precision),
+      d_write_deltas(write_deltas),
+      d_keyframe_interval(keyframe_interval),
+      d_num_dumps(0),
+      d_reference_time_step_number(-1),
+      d_reference_lower(0),
+      d_reference_upper(0)
+{
+    if (d_write_deltas && d_keyframe_interval < 1)
+    {
+        TBOX_ERROR(d_object_name << "::LagrangianDataWriter() :\n"
+                                 << "  keyframe_interval = " << d_keyframe_interval << " must be positive"
+                                 << std::endl);
+    }
+    return;
+} // LagrangianDataWriter
+
+void
+LagrangianDataWriter::writeData(Vec X_lag_vec, const int time_step_number, const double simulation_time)
+{
+    PetscInt lower, upper, size;
+    VecGetOwnershipRange(X_lag_vec, &lower, &upper);
+    VecGetSize(X_lag_vec, &size);
+    const int num_local_values = static_cast<int>(upper - lower);
+
+    // Write deltas only when every rank still owns the range of the reference dump.
+    int is_keyframe = !d_write_deltas || d_num_dumps % d_keyframe_interval == 0 || lower != d_reference_lower ||
+                      upper != d_reference_upper;
+    MPI_Allreduce(MPI_IN_PLACE, &is_keyframe, 1, MPI_INT, MPI_LOR, PETSC_COMM_WORLD);
+
+    // Convert the local values to the precision of the file, and keep the positions that a reader reconstructs
+    // from them as the reference of the next dump.
+    const PetscScalar* X;
+    VecGetArrayRead(X_lag_vec, &X);
+    if (d_write_deltas) d_reference_X.resize(num_local_values);
+    if (d_use_single_precision)
+    {
+        d_float_buffer.resize(num_local_values);
+        for (int i = 0; i < num_local_values; ++i)
+        {
+            const double base = is_keyframe ? 0.0 : d_reference_X[i];
+            d_float_buffer[i] = static_cast<float>(X[i] - base);
+            if (d_write_deltas) d_reference_X[i] = base + static_cast<double>(d_float_buffer[i]);
+        }
+    }
+    else
+    {
+        d_double_buffer.resize(num_local_values);
+        for (int i = 0; i < num_local_values; ++i)
+        {
+            const double base = is_keyframe ? 0.0 : d_reference_X[i];
+            d_double_buffer[i] = X[i] - base;
+            if (d_write_deltas) d_reference_X[i] = base + d_double_buffer[i];
+        }
+    }
+    VecRestoreArrayRead(X_lag_vec, &X);
+
+    // Header.
+    char header[HEADER_SIZE];
+    const int header_ints[6] = { FILE_VERSION,
+                                 NDIM,
+                                 time_step_number,
+                                 d_use_single_precision ? 4 : 8,
+                                 is_keyframe ? 0 : 1,
+                                 is_keyframe ? time_step_number : d_reference_time_step_number };
+    const long long num_points = static_cast<long long>(size) / NDIM;
+    std::memcpy(header, FILE_MAGIC, 8);
+    std::memcpy(header + 8, header_ints, sizeof(header_ints));
+    std::memcpy(header + 32, &num_points, 8);
+    std::memcpy(header + 40, &simulation_time, 8);
+
+    // Every rank writes its range at its offset in the file.
+    char temp_buf[128];
+    std::sprintf(temp_buf, "/X.%05d.bin", time_step_number);
+    const std::string file_name = d_dirname + temp_buf;
+    MPI_File fh;
+    if (MPI_File_open(PETSC_COMM_WORLD,
+                      const_cast<char*>(file_name.c_str()),
+                      MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                      MPI_INFO_NULL,
+                      &fh) != MPI_SUCCESS)
+    {
+        TBOX_ERROR(d_object_name << "::writeData() :\n"
+                                 << "  could not open " << file_name << std::endl);
+    }
+    MPI_File_set_size(fh, 0);
+    if (IBTK_MPI::getRank() == 0)
+    {
+        MPI_File_write_at(fh, 0, header, HEADER_SIZE, MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+    const int value_size = d_use_single_precision ? 4 : 8;
+    const MPI_Offset offset = HEADER_SIZE + static_cast<MPI_Offset>(lower) * value_size;
+    int status;
+    if (d_use_single_precision)
+    {
+        status = MPI_File_write_at_all(
+            fh, offset, d_float_buffer.data(), num_local_values, MPI_FLOAT, MPI_STATUS_IGNORE);
+    }
+    else
+    {
+        status = MPI_File_write_at_all(
+            fh, offset, d_double_buffer.data(), num_local_values, MPI_DOUBLE, MPI_STATUS_IGNORE);
+    }
+    MPI_File_close(&fh);
+    if (status != MPI_SUCCESS)
+    {
+        TBOX_ERROR(d_object_name << "::writeData() :\n"
+                                 << "  could not write " << file_name << std::endl);
+    }
+
+    ++d_num_dumps;
+    d_reference_time_step_number = time_step_number;
+    d_reference_lower = lower;
+    d_reference_upper = upper;
+    return;
+} // writeData
+
+} // namespace IBAMR
@@ -0,0 +1,99 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_LagrangianDataWriter
+#define included_LagrangianDataWriter
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include <petscvec.h>
+
+#include <string>
+#include <vector>
+
+namespace IBAMR
+{
+/*!
+ * \brief Class LagrangianDataWriter writes the positions of the Lagrangian points to binary files with MPI-IO.
+ *
+ * Each rank writes the part of the Lagrangian ordered position vector that it owns directly to its offset in
+ * the shared file dirname/X.NNNNN.bin (NNNNN the time step number), so no rank gathers the vector. The file
+ * starts with a 48 byte header in the native byte order:
+ *
+ * - the 8 characters EEL2DLAG, then int32 version, dimension, time step number, bytes per value (4 or 8),
+ *   delta flag and reference time step number;
+ * - int64 number of points and float64 time;
+ *
+ * followed by the values, point by point and component by component. A file with the delta flag set holds the
+ * change of the positions since the dump of the reference time step. The positions are then reconstructed by
+ * adding the deltas in double precision to the positions of the reference dump, which the writer reproduces
+ * exactly, so rounding the deltas to single precision does not accumulate over a series. Every
+ * keyframe_interval-th dump, the first dump of a run, and any dump after the partition of the points has
+ * changed hold the full positions. scripts/read_lagrangian_data.py reads these files.
+ */
+class LagrangianDataWriter
+{
+public:
+    /*!
+     * \brief Constructor.
+     */
+    LagrangianDataWriter(const std::string& object_name,
+                         const std::string& dirname,
+                         const bool use_single_precision,
+                         const bool write_deltas,
+                         const int keyframe_interval);
+
+    /*!
+     * \brief Write the positions in the Lagrangian ordered vector X_lag_vec; collective.
+     */
+    void writeData(Vec X_lag_vec, const int time_step_number, const double simulation_time);
+
+private:
+    /*!
+     * \brief Default constructor (not implemented).
+     */
+    LagrangianDataWriter();
+
+    /*!
+     * \brief Copy constructor (not implemented).
+     */
+    LagrangianDataWriter(const LagrangianDataWriter& from);
+
+    /*!
+     * \brief Assignment operator (not implemented).
+     */
+    LagrangianDataWriter& operator=(const LagrangianDataWriter& that);
+
+    std::string d_object_name, d_dirname;
+    bool d_use_single_precision, d_write_deltas;
+    int d_keyframe_interval;
+
+    /*!
+     * Number of dumps written so far, and the time step number, owned range and reconstructed positions of the
+     * last one.
+     */
+    int d_num_dumps, d_reference_time_step_number;
+    PetscInt d_reference_lower, d_reference_upper;
+    std::vector<double> d_reference_X;
+
+    /*!
+     * Values of the local range in the precision of the file.
+     */
+    std::vector<double> d_double_buffer;
+    std::vector<float> d_float_buffer;
+
+}; // LagrangianDataWriter
+
+} // namespace IBAMR
+
+#endif // #ifndef included_LagrangianDataWriter
@@ -0,0 +1,133 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+//////////////////////////// INCLUDES /////////////////////////////////////////
+#include "PatchDataSnapshot.h"
+#include "Box.h"
+#include "CartesianPatchGeometry.h"
+#include "CellData.h"
+#include "CellIterator.h"
+#include "CellVariable.h"
+#include "Patch.h"
+#include "PatchLevel.h"
+#include "SideData.h"
+#include "SideIterator.h"
+#include "SideVariable.h"
+#include "VariableDatabase.h"
+#include "tbox/Utilities.h"
+
+#include "ibamr/namespaces.h"
+
+namespace IBAMR
+{
+PatchDataSnapshot::PatchDataSnapshot(const std::string& object_name) : d_object_name(object_name)
+{
+    return;
+} // PatchDataSnapshot
+
+void
+PatchDataSnapshot::registerPatchData(const std::string& name, const int patch_data_idx)
+{
+    Pointer<SAMRAI::hier::Variable<NDIM> > var;
+    if (!VariableDatabase<NDIM>::getDatabase()->mapIndexToVariable(patch_data_idx, var))
+    {
+        TBOX_ERROR(d_object_name << "::registerPatchData() :\n"
+                                 << "  no variable for patch data index " << patch_data_idx << std::endl);
+    }
+    Variable plot_var;
+    plot_var.name = name;
+    plot_var.patch_data_idx = patch_data_idx;
+    Pointer<CellVariable<NDIM, double> > cc_var = var;
+    Pointer<SideVariable<NDIM, double> > sc_var = var;
+    if (!cc_var.isNull())
+    {
+        plot_var.centering = CELL_CENTERING;
+        plot_var.depth = cc_var->getDepth();
+    }
+    else if (!sc_var.isNull())
+    {
+        plot_var.centering = SIDE_CENTERING;
+        plot_var.depth = sc_var->getDepth();
+    }
+    else
+    {
+        TBOX_ERROR(d_object_name << "::registerPatchData() :\n"
+                                 << "  " << name << " is not cell or side centered double precision data"
+                                 << std::endl);
+    }
+    d_variables.push_back(plot_var);
+    return;
+} // registerPatchData
+
+void
+PatchDataSnapshot::copyPatchData(Pointer<PatchHierarchy<NDIM> > hierarchy)
+{
+    d_patches.clear();
+    d_values.clear();
+    const int finest_ln = hierarchy->getFinestLevelNumber();
+    for (int ln = 0; ln <= finest_ln; ++ln)
+    {
+        Pointer<PatchLevel<NDIM> > level = hierarchy->getPatchLevel(ln);
+        for (PatchLevel<NDIM>::Iterator p(level); p; p++)
+        {
+            Pointer<Patch<NDIM> > patch = level->getPatch(p());
+            const Box<NDIM>& patch_box = patch->getBox();
+            const Pointer<CartesianPatchGeometry<NDIM> > pgeom = patch->getPatchGeometry();
+            for (int var = 0; var < static_cast<int>(d_variables.size()); ++var)
+            {
+                const Variable& plot_var = d_variables[var];
+                PatchRecord record;
+                record.level_number = ln;
+                record.variable = var;
+                for (int d = 0; d < NDIM; ++d)
+                {
+                    record.lower[d] = patch_box.lower(d);
+                    record.upper[d] = patch_box.upper(d);
+                    record.x_lower[d] = pgeom->getXLower()[d];
+                    record.dx[d] = pgeom->getDx()[d];
+                }
+                record.offset = d_values.size();
+                if (plot_var.centering == CELL_CENTERING)
+                {
+                    Pointer<CellData<NDIM, double> > data = patch->getPatchData(plot_var.patch_data_idx);
+                    for (int k = 0; k < plot_var.depth; ++k)
+                    {
+                        for (CellIterator<NDIM> b(patch_box); b; b++)
+                        {
+                            d_values.push_back((*data)(b(), k));
+                        }
+                    }
+                }
+                else
+                {
+                    Pointer<SideData<NDIM, double> > data = patch->getPatchData(plot_var.patch_data_idx);
+                    for (int axis = 0; axis < NDIM; ++axis)
+                    {
+                        for (int k = 0; k < plot_var.depth; ++k)
+                        {
+                            for (SideIterator<NDIM> b(patch_box, axis); b; b++)
+                            {
+                                d_values.push_back((*data)(b(), k));
+                            }
+                        }
+                    }
+                }
+                record.num_values = d_values.size() - record.offset;
+                d_patches.push_back(record);
+            }
+        }
+    }
+    return;
+} // copyPatchData
+
+} // namespace IBAMR
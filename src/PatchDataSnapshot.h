@@ -0,0 +1,110 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_PatchDataSnapshot
+#define included_PatchDataSnapshot
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include <PatchHierarchy.h>
+#include <tbox/Pointer.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace IBAMR
+{
+/*!
+ * \brief Class PatchDataSnapshot copies the interior values of cell and side centered double precision patch
+ * data on the local patches of a hierarchy into contiguous buffers, for the output writers.
+ *
+ * The values of a patch are stored, for cell data, as depth blocks over the cells of the patch box and, for
+ * side data, as depth blocks over the sides normal to each axis in turn, the first index varying fastest. The
+ * buffers keep their capacity between copies, so that after the first copy they allocate only when the
+ * hierarchy has grown.
+ */
+class PatchDataSnapshot
+{
+public:
+    enum Centering
+    {
+        CELL_CENTERING = 0,
+        SIDE_CENTERING = 1
+    };
+
+    /*!
+     * \brief A registered patch data index.
+     */
+    struct Variable
+    {
+        std::string name;
+        int patch_data_idx, centering, depth;
+    };
+
+    /*!
+     * \brief The values of one variable on one local patch.
+     */
+    struct PatchRecord
+    {
+        int level_number, variable, lower[NDIM], upper[NDIM];
+        double x_lower[NDIM], dx[NDIM];
+        std::size_t offset, num_values;
+    };
+
+    /*!
+     * \brief Constructor.
+     */
+    PatchDataSnapshot(const std::string& object_name);
+
+    /*!
+     * \brief Register cell or side centered double precision patch data to be copied under the given name.
+     */
+    void registerPatchData(const std::string& name, const int patch_data_idx);
+
+    /*!
+     * \brief Replace the buffers by a copy of the registered data on the local patches of all levels.
+     */
+    void copyPatchData(SAMRAI::tbox::Pointer<SAMRAI::hier::PatchHierarchy<NDIM> > hierarchy);
+
+    const std::vector<Variable>& getVariables() const
+    {
+        return d_variables;
+    }
+
+    const std::vector<PatchRecord>& getPatches() const
+    {
+        return d_patches;
+    }
+
+    const std::vector<double>& getValues() const
+    {
+        return d_values;
+    }
+
+private:
+    /*!
+     * \brief Default constructor (not implemented).
+     */
+    PatchDataSnapshot();
+
+    std::string d_object_name;
+    std::vector<Variable> d_variables;
+    std::vector<PatchRecord> d_patches;
+    std::vector<double> d_values;
+
+}; // PatchDataSnapshot
+
+} // namespace IBAMR
+
+#endif // #ifndef included_PatchDataSnapshot
@@ -0,0 +1,198 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+//////////////////////////// INCLUDES /////////////////////////////////////////
+
+#include "AllocationCounter.h"
+#include "PerformanceMetricsWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace IBAMR
+{
+PerformanceMetricsWriter::PerformanceMetricsWriter()
+    : d_num_columns(0),
+      d_flush_rows(1),
+      d_flush_interval(0.0),
+      d_num_appended(0),
+      d_num_written(0),
+      d_flush_requested(false),
+      d_stop(false)
+{
+    return;
+} // PerformanceMetricsWriter
+
+PerformanceMetricsWriter::~PerformanceMetricsWriter()
+{
+    close();
+    return;
+} // ~PerformanceMetricsWriter
+
+void
+PerformanceMetricsWriter::open(const std::string& file_name,
+                               const std::string& header,
+                               const int num_columns,
+                               const bool resume,
+                               const double restart_time,
+                               const int flush_rows,
+                               const double flush_interval)
+{
+    // A timed wait of zero length returns at once, so the thread would spin.
+    if (!(flush_interval > 0.0))
+    {
+        throw std::invalid_argument("PerformanceMetricsWriter: flush_interval must be positive");
+    }
+
+    close();
+    d_file_name = file_name;
+    d_num_columns = num_columns;
+    d_flush_rows = std::max(flush_rows, 1);
+    d_flush_interval = flush_interval;
+
+    if (resume)
+    {
+        truncateAfter(restart_time, header);
+    }
+    else
+    {
+        std::ofstream outfile(d_file_name.c_str(), std::ios::out);
+        outfile << header;
+    }
+    d_stream.open(d_file_name.c_str(), std::ios::app);
+    d_stream << std::scientific << std::setprecision(8);
+
+    // Reserve room for twice the flush size, so that appending does not allocate while the thread writes.
+    d_pending.clear();
+    d_writing.clear();
+    d_pending.reserve(2 * d_flush_rows * d_num_columns);
+    d_writing.reserve(2 * d_flush_rows * d_num_columns);
+    d_num_appended = 0;
+    d_num_written = 0;
+    d_flush_requested = false;
+    d_stop = false;
+    d_thread = std::thread(&PerformanceMetricsWriter::run, this);
+    return;
+} // open
+
+void
+PerformanceMetricsWriter::append(const double* row)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_pending.insert(d_pending.end(), row, row + d_num_columns);
+    ++d_num_appended;
+    if (static_cast<int>(d_pending.size()) >= d_flush_rows * d_num_columns) d_wake.notify_one();
+    return;
+} // append
+
+void
+PerformanceMetricsWriter::flush()
+{
+    if (!isOpen()) return;
+    std::unique_lock<std::mutex> lock(d_mutex);
+    const std::size_t num_rows = d_num_appended;
+    d_flush_requested = true;
+    d_wake.notify_one();
+    d_written.wait(lock, [this, num_rows] { return d_num_written >= num_rows; });
+    return;
+} // flush
+
+void
+PerformanceMetricsWriter::close()
+{
+    if (!isOpen()) return;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stop = true;
+    }
+    d_wake.notify_one();
+    d_thread.join();
+    d_stream.close();
+    return;
+} // close
+
+void
+PerformanceMetricsWriter::truncateAfter(const double restart_time, const std::string& header)
+{
+    std::ifstream infile(d_file_name.c_str());
+    if (!infile)
+    {
+        std::ofstream outfile(d_file_name.c_str(), std::ios::out);
+        outfile << header;
+        return;
+    }
+
+    // Keep comments and the rows up to the restart time; allow for the rounding of the printed time.
+    std::ostringstream kept;
+    std::string line;
+    const double tolerance = 1.0e-7 * std::max(1.0, std::abs(restart_time));
+    while (std::getline(infile, line))
+    {
+        std::istringstream fields(line);
+        double time;
+        if (line.empty() || line[0] == '#' || !(fields >> time) || time <= restart_time + tolerance)
+        {
+            kept << line << '\n';
+        }
+    }
+    infile.close();
+
+    std::ofstream outfile(d_file_name.c_str(), std::ios::out);
+    outfile << kept.str();
+    return;
+} // truncateAfter
+
+void
+PerformanceMetricsWriter::run()
+{
+    AllocationCounter::ignoreCallingThread();
+    const std::chrono::duration<double> flush_interval(d_flush_interval);
+    std::unique_lock<std::mutex> lock(d_mutex);
+    while (true)
+    {
+        // Wake up when enough rows are pending, on request, or when the flush interval has passed.
+        d_wake.wait_for(lock, flush_interval, [this] {
+            return d_stop || d_flush_requested || static_cast<int>(d_pending.size()) >= d_flush_rows * d_num_columns;
+        });
+
+        if (!d_pending.empty())
+        {
+            d_writing.swap(d_pending);
+            const std::size_t num_rows = d_writing.size() / d_num_columns;
+            lock.unlock();
+
+            for (std::size_t i = 0; i < num_rows; ++i)
+            {
+                const double* const row = d_writing.data() + i * d_num_columns;
+                for (int j = 0; j < d_num_columns; ++j) d_stream << (j ? " " : "") << row[j];
+                d_stream << '\n';
+            }
+            d_stream.flush();
+            d_writing.clear();
+
+            lock.lock();
+            d_num_written += num_rows;
+        }
+        if (d_num_written == d_num_appended) d_flush_requested = false;
+        d_written.notify_all();
+
+        if (d_stop && d_pending.empty()) break;
+    }
+    return;
+} // run
+
+} // namespace IBAMR
@@ -0,0 +1,136 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_PerformanceMetricsWriter
+#define included_PerformanceMetricsWriter
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace IBAMR
+{
+/*!
+ * \brief Class PerformanceMetricsWriter appends rows of numbers to a text file from a background thread.
+ *
+ * append() only copies the values of a row into an in-memory buffer. The rows are formatted and written
+ * by a background thread once flush_rows rows are pending, or at the latest flush_interval seconds (wall
+ * clock) after the previous write, so the time stepping never waits on the file system.
+ *
+ * When a restarted run resumes the file, rows whose first column (time) lies past the restart time were
+ * written after the restart dump and will be produced again; they are dropped before appending, so the
+ * history is kept without duplicates.
+ */
+class PerformanceMetricsWriter
+{
+public:
+    /*!
+     * \brief Default constructor (no file open).
+     */
+    PerformanceMetricsWriter();
+
+    /*!
+     * \brief Destructor; writes all pending rows and closes the file.
+     */
+    ~PerformanceMetricsWriter();
+
+    /*!
+     * \brief Open the file and start the background thread.
+     *
+     * A new file starts with the given header. With resume = true an existing file is kept up to and
+     * including the rows at restart_time, and new rows are appended to it.
+     *
+     * \note flush_interval must be positive; std::invalid_argument is thrown otherwise.
+     */
+    void open(const std::string& file_name,
+              const std::string& header,
+              const int num_columns,
+              const bool resume,
+              const double restart_time,
+              const int flush_rows,
+              const double flush_interval);
+
+    /*!
+     * \brief Queue a row of num_columns values, the first one being the time.
+     */
+    void append(const double* row);
+
+    /*!
+     * \brief Block until all rows appended so far have been written to the file.
+     */
+    void flush();
+
+    /*!
+     * \brief Write all pending rows, stop the background thread and close the file.
+     */
+    void close();
+
+    /*!
+     * \brief Whether a file is open.
+     */
+    bool isOpen() const
+    {
+        return d_thread.joinable();
+    }
+
+private:
+    /*!
+     * \brief Copy constructor (not implemented).
+     */
+    PerformanceMetricsWriter(const PerformanceMetricsWriter& from);
+
+    /*!
+     * \brief Assignment operator (not implemented).
+     */
+    PerformanceMetricsWriter& operator=(const PerformanceMetricsWriter& that);
+
+    /*!
+     * \brief Keep the header and the rows up to restart_time of an existing file.
+     */
+    void truncateAfter(const double restart_time, const std::string& header);
+
+    /*!
+     * \brief Main loop of the background thread.
+     */
+    void run();
+
+    std::string d_file_name;
+    int d_num_columns, d_flush_rows;
+    double d_flush_interval;
+
+    /*!
+     * Rows appended but not yet handed to the background thread, and the rows being written by it.
+     */
+    std::vector<double> d_pending, d_writing;
+    std::size_t d_num_appended, d_num_written;
+
+    /*!
+     * Synchronization with the background thread, which is the only user of d_stream while it runs.
+     */
+    std::mutex d_mutex;
+    std::condition_variable d_wake, d_written;
+    bool d_flush_requested, d_stop;
+    std::thread d_thread;
+    std::ofstream d_stream;
+
+}; // PerformanceMetricsWriter
+
+} // namespace IBAMR
+
+#endif // #ifndef included_PerformanceMetricsWriter
@@ -0,0 +1,74 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+//////////////////////////// INCLUDES /////////////////////////////////////////
+
+#include "PeriodicShapeCache.h"
+
+#include <cmath>
+
+namespace IBAMR
+{
+PeriodicShapeCache::PeriodicShapeCache() : d_num_sections(0), d_num_phases(0), d_period(1.0)
+{
+    return;
+} // PeriodicShapeCache
+
+void
+PeriodicShapeCache::initialize(const int num_sections, const int num_phases, const double period)
+{
+    d_num_sections = num_sections;
+    d_num_phases = num_phases;
+    d_period = period;
+    d_shape.assign(static_cast<std::size_t>(num_sections) * num_phases, 0.0);
+    d_shape_rate.assign(static_cast<std::size_t>(num_sections) * num_phases, 0.0);
+    return;
+} // initialize
+
+void
+PeriodicShapeCache::interpolate(const double time, double* y, double* dydt) const
+{
+    // Locate the phase interval [k, k+1) containing time, wrapping around the period.
+    const double h = d_period / d_num_phases;
+    double phase = std::fmod(time, d_period) / h;
+    if (phase < 0.0) phase += d_num_phases;
+    int k = static_cast<int>(phase);
+    if (k >= d_num_phases) k = d_num_phases - 1;
+    const int k1 = (k + 1 == d_num_phases) ? 0 : k + 1;
+    const double t = phase - k;
+
+    // Cubic Hermite basis functions and their derivatives with respect to t.
+    const double t2 = t * t, t3 = t2 * t;
+    const double h00 = 2.0 * t3 - 3.0 * t2 + 1.0;
+    const double h10 = (t3 - 2.0 * t2 + t) * h;
+    const double h01 = -2.0 * t3 + 3.0 * t2;
+    const double h11 = (t3 - t2) * h;
+    const double dh00 = (6.0 * t2 - 6.0 * t) / h;
+    const double dh10 = 3.0 * t2 - 4.0 * t + 1.0;
+    const double dh01 = (-6.0 * t2 + 6.0 * t) / h;
+    const double dh11 = 3.0 * t2 - 2.0 * t;
+
+    const double* const y0 = d_shape.data() + k * d_num_sections;
+    const double* const y1 = d_shape.data() + k1 * d_num_sections;
+    const double* const m0 = d_shape_rate.data() + k * d_num_sections;
+    const double* const m1 = d_shape_rate.data() + k1 * d_num_sections;
+    for (int i = 0; i < d_num_sections; ++i)
+    {
+        y[i] = h00 * y0[i] + h10 * m0[i] + h01 * y1[i] + h11 * m1[i];
+        dydt[i] = dh00 * y0[i] + dh10 * m0[i] + dh01 * y1[i] + dh11 * m1[i];
+    }
+
+    return;
+} // interpolate
+
+} // namespace IBAMR
@@ -0,0 +1,99 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_PeriodicShapeCache
+#define included_PeriodicShapeCache
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include <vector>
+
+namespace IBAMR
+{
+/*!
+ * \brief Class PeriodicShapeCache tabulates a time-periodic backbone deformation y(s,t) and its time
+ * derivative dy/dt at a fixed number of phases over one period.
+ *
+ * Values at intermediate times are reconstructed by cubic Hermite interpolation in time using both
+ * tabulated y and dy/dt; the returned velocity is the exact time derivative of the interpolated shape,
+ * so that shape and velocity stay consistent. The table is stored phase-major, so each interpolation
+ * streams through two contiguous rows.
+ */
+class PeriodicShapeCache
+{
+public:
+    /*!
+     * \brief Default constructor (empty cache).
+     */
+    PeriodicShapeCache();
+
+    /*!
+     * \brief Allocate a table for the given number of sections and phases over one period.
+     */
+    void initialize(const int num_sections, const int num_phases, const double period);
+
+    /*!
+     * \brief Time of the given phase within the first period.
+     */
+    double getPhaseTime(const int phase) const
+    {
+        return phase * d_period / d_num_phases;
+    }
+
+    /*!
+     * \brief Rows of the table to be filled with y and dy/dt at getPhaseTime(phase).
+     */
+    double* getShapeRow(const int phase)
+    {
+        return d_shape.data() + phase * d_num_sections;
+    }
+    double* getShapeRateRow(const int phase)
+    {
+        return d_shape_rate.data() + phase * d_num_sections;
+    }
+
+    /*!
+     * \brief Interpolate y and dy/dt at all sections at the given time.
+     */
+    void interpolate(const double time, double* y, double* dydt) const;
+
+    /*!
+     * \brief Number of tabulated phases.
+     */
+    int getNumberOfPhases() const
+    {
+        return d_num_phases;
+    }
+
+    /*!
+     * \brief Whether the table has been allocated.
+     */
+    bool isInitialized() const
+    {
+        return d_num_phases > 0;
+    }
+
+private:
+    int d_num_sections, d_num_phases;
+    double d_period;
+
+    /*!
+     * Tabulated y and dy/dt, indexed [phase * num_sections + section].
+     */
+    std::vector<double> d_shape, d_shape_rate;
+
+}; // PeriodicShapeCache
+
+} // namespace IBAMR
+
+#endif // #ifndef included_PeriodicShapeCache
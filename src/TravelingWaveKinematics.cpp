@@ -0,0 +1,84 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+//////////////////////////// INCLUDES /////////////////////////////////////////
+
+#include "TravelingWaveKinematics.h"
+
+#include <cmath>
+
+namespace IBAMR
+{
+TravelingWaveKinematics::TravelingWaveKinematics()
+    : d_amplitude(0.0),
+      d_envelope_offset(0.0),
+      d_envelope_length(1.0),
+      d_envelope_power(1.0),
+      d_wave_number(0.0),
+      d_angular_frequency(0.0)
+{
+    return;
+} // TravelingWaveKinematics
+
+TravelingWaveKinematics::TravelingWaveKinematics(const double amplitude,
+                                                 const double envelope_offset,
+                                                 const double envelope_length,
+                                                 const double envelope_power,
+                                                 const double wave_number,
+                                                 const double angular_frequency)
+    : d_amplitude(amplitude),
+      d_envelope_offset(envelope_offset),
+      d_envelope_length(envelope_length),
+      d_envelope_power(envelope_power),
+      d_wave_number(wave_number),
+      d_angular_frequency(angular_frequency)
+{
+    return;
+} // TravelingWaveKinematics
+
+void
+TravelingWaveKinematics::setBackbone(const std::vector<double>& s)
+{
+    const int num_sections = static_cast<int>(s.size());
+    d_envelope.resize(num_sections);
+    d_spatial_phase.resize(num_sections);
+    for (int i = 0; i < num_sections; ++i)
+    {
+        d_envelope[i] = d_amplitude * std::pow((s[i] + d_envelope_offset) / d_envelope_length, d_envelope_power);
+        d_spatial_phase[i] = d_wave_number * s[i];
+    }
+
+    return;
+} // setBackbone
+
+void
+TravelingWaveKinematics::computeDeformation(const double time, double* y, double* dydt) const
+{
+    const int num_sections = getNumberOfSections();
+    const double* const envelope = d_envelope.data();
+    const double* const spatial_phase = d_spatial_phase.data();
+    const double wt = d_angular_frequency * time;
+    const double w = d_angular_frequency;
+
+    // No branches or lookups in the loop body so that the compiler can vectorize it.
+    for (int i = 0; i < num_sections; ++i)
+    {
+        const double phase = spatial_phase[i] - wt;
+        y[i] = envelope[i] * std::sin(phase);
+        dydt[i] = -w * envelope[i] * std::cos(phase);
+    }
+
+    return;
+} // computeDeformation
+
+} // namespace IBAMR
@@ -0,0 +1,97 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+#ifndef included_TravelingWaveKinematics
+#define included_TravelingWaveKinematics
+
+/////////////////////////////// INCLUDES /////////////////////////////////////
+
+#include <vector>
+
+namespace IBAMR
+{
+/*!
+ * \brief Class TravelingWaveKinematics evaluates the closed-form traveling-wave
+ * deformation of the backbone
+ *
+ *    y(s,t) = A * ((s + c0) / c1)^p * sin(k*s - w*t)
+ *
+ * together with its time derivative dy/dt for all backbone sections in one pass.
+ *
+ * The envelope and the spatial phase depend only on the arc length s, so they are
+ * tabulated once in setBackbone(); each time step then costs one sin/cos pair per
+ * section.
+ */
+class TravelingWaveKinematics
+{
+public:
+    /*!
+     * \brief Default constructor (zero amplitude wave).
+     */
+    TravelingWaveKinematics();
+
+    /*!
+     * \brief Constructor.
+     */
+    TravelingWaveKinematics(const double amplitude,
+                            const double envelope_offset,
+                            const double envelope_length,
+                            const double envelope_power,
+                            const double wave_number,
+                            const double angular_frequency);
+
+    /*!
+     * \brief Tabulate the envelope and the spatial phase at the given arc lengths.
+     */
+    void setBackbone(const std::vector<double>& s);
+
+    /*!
+     * \brief Evaluate y and dy/dt at all backbone sections at the given time.
+     *
+     * \note Both output arrays must hold getNumberOfSections() entries.
+     */
+    void computeDeformation(const double time, double* y, double* dydt) const;
+
+    /*!
+     * \brief Number of tabulated backbone sections.
+     */
+    int getNumberOfSections() const
+    {
+        return static_cast<int>(d_envelope.size());
+    }
+
+    /*!
+     * \brief Angular frequency w of the wave.
+     */
+    double getAngularFrequency() const
+    {
+        return d_angular_frequency;
+    }
+
+private:
+    /*!
+     * Wave parameters.
+     */
+    double d_amplitude, d_envelope_offset, d_envelope_length, d_envelope_power;
+    double d_wave_number, d_angular_frequency;
+
+    /*!
+     * Tabulated A*((s + c0)/c1)^p and k*s for each backbone section.
+     */
+    std::vector<double> d_envelope, d_spatial_phase;
+
+}; // TravelingWaveKinematics
+
+} // namespace IBAMR
+
+#endif // #ifndef included_TravelingWaveKinematics
@@ -37,19 +37,60 @@
 #include <ibtk/IBTKInit.h>
 #include <ibtk/IBTK_MPI.h>
 #include <ibtk/LData.h>
+#include <ibtk/LMesh.h>
+#include <ibtk/LNode.h>
 #include <ibtk/muParserCartGridFunction.h>
 #include <ibtk/muParserRobinBcCoefs.h>
 
+#include <tbox/InputDatabase.h>
+#include <tbox/InputManager.h>
+
 // Set up application namespace declarations
 #include <ibamr/app_namespaces.h>
 
 // Application objects
+#include "AsyncPlotDataWriter.h"
+#include "HierarchyDataWriter.h"
 #include "IBEELKinematics.h"
+#include "LagrangeMultiplierForceEvaluator.h"
+#include "LagrangianDataWriter.h"
+#include "PerformanceMetricsWriter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include <unistd.h>
 
 // Function prototypes
+void run_simulation(int argc,
+                    char* argv[],
+                    Pointer<Database> case_db,
+                    const string& case_name,
+                    const string& base_dirname,
+                    const string& case_dirname);
+
+void apply_case_overrides(Pointer<Database> db, Pointer<Database> overrides, const string& path);
+
+void check_case_overrides_read(Pointer<Database> db, Pointer<Database> overrides, const string& path);
+
+void change_directory(const string& dirname);
+
+void compute_structure_bounding_boxes(LDataManager* l_data_manager,
+                                      const vector<Pointer<IBEELKinematics> >& eel_kinematics,
+                                      const int ln,
+                                      vector<IBTK::Vector3d>& X_lower,
+                                      vector<IBTK::Vector3d>& X_upper);
+
 void output_data(Pointer<PatchHierarchy<NDIM> > patch_hierarchy,
                  Pointer<INSHierarchyIntegrator> navier_stokes_integrator,
                  LDataManager* l_data_manager,
+                 HierarchyDataWriter* hier_writer,
+                 LagrangianDataWriter* X_writer,
                  const int iteration_num,
                  const double loop_time,
                  const string& data_dump_dirname);
@@ -64,301 +105,898 @@ void output_data(Pointer<PatchHierarchy<NDIM> > patch_hierarchy,
  *                                                                             *
  *    executable <input file name> <restart directory> <restart number>        *
  *                                                                             *
+ * An input file with a ParameterSweep database runs each of its cases in      *
+ * turn, in a subdirectory of the current directory named after the case.      *
+ * With the option -ensemble_groups G, the processes are split into G groups,  *
+ * which run different cases of the sweep at the same time:                    *
+ *                                                                             *
+ *    executable <input file name> -ensemble_groups G                          *
+ *                                                                             *
  *******************************************************************************/
 int
 main(int argc, char* argv[])
 {
-    // Initialize IBAMR and libraries. Deinitialization is handled by this object as well.
-    IBTKInit ibtk_init(argc, argv, MPI_COMM_WORLD);
+    // The processes are split into groups of consecutive ranks before the libraries are initialized, so that
+    // PETSc, SAMRAI and IBTK run entirely on the communicator of the group.
+    MPI_Init(&argc, &argv);
+    int num_groups = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-ensemble_groups")) continue;
+        num_groups = i + 1 < argc ? std::atoi(argv[i + 1]) : 0;
+        for (int j = i + 2; j <= argc; ++j) argv[j - 2] = argv[j];
+        argc -= 2;
+        break;
+    }
+    int world_rank, num_world_nodes;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_world_nodes);
+    if (num_groups < 1 || num_groups > num_world_nodes)
+    {
+        if (world_rank == 0)
+        {
+            std::cerr << "main(): -ensemble_groups must be followed by a number of groups between 1 and the number "
+                      << "of processes (" << num_world_nodes << ")" << std::endl;
+        }
+        MPI_Finalize();
+        return EXIT_FAILURE;
+    }
+    const int group = static_cast<int>(static_cast<long>(world_rank) * num_groups / num_world_nodes);
+    MPI_Comm group_comm = MPI_COMM_WORLD;
+    if (num_groups > 1) MPI_Comm_split(MPI_COMM_WORLD, group, world_rank, &group_comm);
+    PETSC_COMM_WORLD = group_comm;
+
+    // Initialize IBAMR and libraries. Deinitialization is handled by this object as well, and must precede
+    // that of MPI.
+    IBTKInit* ibtk_init = new IBTKInit(argc, argv, group_comm);
 
     { // cleanup dynamically allocated objects prior to shutdown
 
-        // Parse command line options, set some standard options from the input
-        // file, initialize the restart database (if this is a restarted run),
-        // and enable file logging.
-        Pointer<AppInitializer> app_initializer = new AppInitializer(argc, argv, "IB.log");
-        Pointer<Database> input_db = app_initializer->getInputDatabase();
-
-        // Get various standard options set in the input file.
-        const bool dump_viz_data = app_initializer->dumpVizData();
-        const int viz_dump_interval = app_initializer->getVizDumpInterval();
-        const bool uses_visit = dump_viz_data && !app_initializer->getVisItDataWriter().isNull();
-
-        const bool dump_restart_data = app_initializer->dumpRestartData();
-        const int restart_dump_interval = app_initializer->getRestartDumpInterval();
-        const string restart_dump_dirname = app_initializer->getRestartDumpDirectory();
-
-        const bool dump_postproc_data = app_initializer->dumpPostProcessingData();
-        const int postproc_data_dump_interval = app_initializer->getPostProcessingDataDumpInterval();
-        const string postproc_data_dump_dirname = app_initializer->getPostProcessingDataDumpDirectory();
-        if (dump_postproc_data && (postproc_data_dump_interval > 0) && !postproc_data_dump_dirname.empty())
-        {
-            Utilities::recursiveMkdir(postproc_data_dump_dirname);
-        }
-
-        const bool dump_timer_data = app_initializer->dumpTimerData();
-        const int timer_dump_interval = app_initializer->getTimerDumpInterval();
-
-        // Create major algorithm and data objects that comprise the
-        // application.  These objects are configured from the input database
-        // and, if this is a restarted run, from the restart database.
-        Pointer<INSHierarchyIntegrator> navier_stokes_integrator = new INSStaggeredHierarchyIntegrator(
-            "INSStaggeredHierarchyIntegrator",
-            app_initializer->getComponentDatabase("INSStaggeredHierarchyIntegrator"));
-
-        const int num_structures = input_db->getIntegerWithDefault("num_structures", 1);
-        Pointer<ConstraintIBMethod> ib_method_ops = new ConstraintIBMethod(
-            "ConstraintIBMethod", app_initializer->getComponentDatabase("ConstraintIBMethod"), num_structures);
-        Pointer<IBHierarchyIntegrator> time_integrator =
-            new IBExplicitHierarchyIntegrator("IBHierarchyIntegrator",
-                                              app_initializer->getComponentDatabase("IBHierarchyIntegrator"),
-                                              ib_method_ops,
-                                              navier_stokes_integrator);
-
-        Pointer<CartesianGridGeometry<NDIM> > grid_geometry = new CartesianGridGeometry<NDIM>(
-            "CartesianGeometry", app_initializer->getComponentDatabase("CartesianGeometry"));
-        Pointer<PatchHierarchy<NDIM> > patch_hierarchy = new PatchHierarchy<NDIM>("PatchHierarchy", grid_geometry);
-
-        Pointer<StandardTagAndInitialize<NDIM> > error_detector =
-            new StandardTagAndInitialize<NDIM>("StandardTagAndInitialize",
-                                               time_integrator,
-                                               app_initializer->getComponentDatabase("StandardTagAndInitialize"));
-        Pointer<BergerRigoutsos<NDIM> > box_generator = new BergerRigoutsos<NDIM>();
-        Pointer<LoadBalancer<NDIM> > load_balancer =
-            new LoadBalancer<NDIM>("LoadBalancer", app_initializer->getComponentDatabase("LoadBalancer"));
-        Pointer<GriddingAlgorithm<NDIM> > gridding_algorithm =
-            new GriddingAlgorithm<NDIM>("GriddingAlgorithm",
-                                        app_initializer->getComponentDatabase("GriddingAlgorithm"),
-                                        error_detector,
-                                        box_generator,
-                                        load_balancer);
-
-        // Configure the IB solver.
-        Pointer<IBStandardInitializer> ib_initializer = new IBStandardInitializer(
-            "IBStandardInitializer", app_initializer->getComponentDatabase("IBStandardInitializer"));
-        ib_method_ops->registerLInitStrategy(ib_initializer);
-        Pointer<IBStandardForceGen> ib_force_fcn = new IBStandardForceGen();
-        ib_method_ops->registerIBLagrangianForceFunction(ib_force_fcn);
-
-        // Create Eulerian initial condition specification objects.
-        if (input_db->keyExists("VelocityInitialConditions"))
-        {
-            Pointer<CartGridFunction> u_init = new muParserCartGridFunction(
-                "u_init", app_initializer->getComponentDatabase("VelocityInitialConditions"), grid_geometry);
-            navier_stokes_integrator->registerVelocityInitialConditions(u_init);
-        }
-
-        if (input_db->keyExists("PressureInitialConditions"))
-        {
-            Pointer<CartGridFunction> p_init = new muParserCartGridFunction(
-                "p_init", app_initializer->getComponentDatabase("PressureInitialConditions"), grid_geometry);
-            navier_stokes_integrator->registerPressureInitialConditions(p_init);
-        }
-
-        // Create Eulerian boundary condition specification objects (when necessary).
-        const IntVector<NDIM>& periodic_shift = grid_geometry->getPeriodicShift();
-        vector<RobinBcCoefStrategy<NDIM>*> u_bc_coefs(NDIM);
-        if (periodic_shift.min() > 0)
-        {
-            for (unsigned int d = 0; d < NDIM; ++d)
-            {
-                u_bc_coefs[d] = nullptr;
-            }
+        // Look for a parameter sweep in the input file.
+        Pointer<Database> sweep_db;
+        if (argc >= 2)
+        {
+            Pointer<Database> input_db = new InputDatabase("input_db");
+            InputManager::getManager()->parseInputFile(argv[1], input_db);
+            if (input_db->isDatabase("ParameterSweep")) sweep_db = input_db->getDatabase("ParameterSweep");
+        }
+        if (sweep_db.isNull())
+        {
+            if (num_groups > 1) TBOX_ERROR("main(): -ensemble_groups requires a ParameterSweep" << endl);
+            run_simulation(argc, argv, Pointer<Database>(), "", "", "");
         }
         else
         {
-            for (unsigned int d = 0; d < NDIM; ++d)
+            if (argc != 2)
             {
-                const std::string bc_coefs_name = "u_bc_coefs_" + std::to_string(d);
+                TBOX_ERROR("main(): a parameter sweep cannot be restarted; run the remaining cases as a new sweep"
+                           << endl);
+            }
 
-                const std::string bc_coefs_db_name = "VelocityBcCoefs_" + std::to_string(d);
+            // The cases run in subdirectories, so they are given the input file by its absolute path.
+            char cwd[4096];
+            if (!::getcwd(cwd, sizeof(cwd))) TBOX_ERROR("main(): cannot get the current directory" << endl);
+            const string base_dirname = cwd;
+            string input_filename = argv[1];
+            if (input_filename.empty() || input_filename[0] != '/')
+            {
+                input_filename = base_dirname + "/" + input_filename;
+            }
+            vector<char> input_filename_buf(input_filename.begin(), input_filename.end());
+            input_filename_buf.push_back('\0');
+            char* case_argv[] = { argv[0], input_filename_buf.data(), NULL };
+
+            // Group g runs the cases g, g + num_groups, ...
+            const Array<string> case_names = sweep_db->getStringArray("case_names");
+            const Array<string> sweep_keys = sweep_db->getAllKeys();
+            for (int k = 0; k < sweep_keys.getSize(); ++k)
+            {
+                if (sweep_keys[k] == "case_names") continue;
+                bool is_case = false;
+                for (int j = 0; j < case_names.getSize() && !is_case; ++j) is_case = sweep_keys[k] == case_names[j];
+                if (!is_case)
+                {
+                    TBOX_ERROR("main(): ParameterSweep entry " << sweep_keys[k] << " is not one of the case_names"
+                                                               << endl);
+                }
+            }
+            if (num_groups > case_names.getSize())
+            {
+                TBOX_ERROR("main(): " << num_groups << " ensemble groups for " << case_names.getSize() << " cases"
+                                      << endl);
+            }
+            const string group_label = num_groups > 1 ? " (group " + std::to_string(group) + ")" : "";
 
-                u_bc_coefs[d] = new muParserRobinBcCoefs(
-                    bc_coefs_name, app_initializer->getComponentDatabase(bc_coefs_db_name), grid_geometry);
+            for (int k = group; k < case_names.getSize(); k += num_groups)
+            {
+                const string& case_name = case_names[k];
+                if (!sweep_db->isDatabase(case_name))
+                {
+                    TBOX_ERROR("main(): no ParameterSweep database for case " << case_name << endl);
+                }
+                const string case_dirname = base_dirname + "/" + case_name;
+                Utilities::recursiveMkdir(case_dirname);
+                IBTK_MPI::barrier();
+                change_directory(case_dirname);
+                TimerManager::getManager()->resetAllTimers();
+
+                pout << "\nParameter sweep" << group_label << ": running case " << case_name << " (" << k + 1
+                     << " of " << case_names.getSize() << ") in " << case_dirname << "\n\n";
+                const double start_wall_time = MPI_Wtime();
+                run_simulation(2, case_argv, sweep_db->getDatabase(case_name), case_name, base_dirname, case_dirname);
+                pout << "\nParameter sweep" << group_label << ": case " << case_name << " took "
+                     << MPI_Wtime() - start_wall_time << " s\n\n";
+
+                // The restart items of the case went away with its objects.
+                change_directory(base_dirname);
+                RestartManager::getManager()->clearRestartItems();
             }
-            navier_stokes_integrator->registerPhysicalBoundaryConditions(u_bc_coefs);
         }
 
-        // Create Eulerian body force function specification objects.
-        if (input_db->keyExists("ForcingFunction"))
+    } // cleanup dynamically allocated objects prior to shutdown
+
+    delete ibtk_init;
+    if (num_groups > 1) MPI_Comm_free(&group_comm);
+    MPI_Finalize();
+} // main
+
+void
+run_simulation(int argc,
+               char* argv[],
+               Pointer<Database> case_db,
+               const string& case_name,
+               const string& base_dirname,
+               const string& case_dirname)
+{
+    // Parse command line options, set some standard options from the input
+    // file, initialize the restart database (if this is a restarted run),
+    // and enable file logging.
+    Pointer<AppInitializer> app_initializer = new AppInitializer(argc, argv, "IB.log");
+    Pointer<Database> input_db = app_initializer->getInputDatabase();
+
+    // A case of a parameter sweep overrides entries of the input database. Its SAMRAI and IBAMR objects get
+    // names of their own, since the variables they register with the variable database outlive them.
+    if (!case_db.isNull())
+    {
+        apply_case_overrides(input_db, case_db, "");
+
+        // MU was substituted into the integrator's mu when the input file was parsed, so a case that sets MU
+        // passes it on; the force evaluation below reads MU itself.
+        if (case_db->keyExists("MU"))
         {
-            Pointer<CartGridFunction> f_fcn = new muParserCartGridFunction(
-                "f_fcn", app_initializer->getComponentDatabase("ForcingFunction"), grid_geometry);
-            time_integrator->registerBodyForceFunction(f_fcn);
+            Pointer<Database> ins_db = input_db->getDatabase("INSStaggeredHierarchyIntegrator");
+            if (case_db->isDatabase("INSStaggeredHierarchyIntegrator") &&
+                case_db->getDatabase("INSStaggeredHierarchyIntegrator")->keyExists("mu"))
+            {
+                TBOX_ERROR("run_simulation(): case " << case_name << " sets both MU and the mu of "
+                                                     << "INSStaggeredHierarchyIntegrator" << endl);
+            }
+            ins_db->putDouble("mu", input_db->getDouble("MU"));
         }
-
-        // Set up visualization plot file writers.
-        Pointer<VisItDataWriter<NDIM> > visit_data_writer = app_initializer->getVisItDataWriter();
-        Pointer<LSiloDataWriter> silo_data_writer = app_initializer->getLSiloDataWriter();
-        if (uses_visit)
+    }
+    const string name_suffix = case_name.empty() ? "" : "::" + case_name;
+
+    // Get various standard options set in the input file.
+    const bool dump_viz_data = app_initializer->dumpVizData();
+    const int viz_dump_interval = app_initializer->getVizDumpInterval();
+    const bool uses_visit = dump_viz_data && !app_initializer->getVisItDataWriter().isNull();
+    const string viz_dump_dirname = app_initializer->getVizDumpDirectory();
+
+    // With async_viz_output, the plot data are copied at each dump and written by a background thread (see
+    // AsyncPlotDataWriter) instead of by the VisIt and Silo writers.
+    const bool uses_async_viz = dump_viz_data && input_db->getBoolWithDefault("async_viz_output", false);
+
+    const bool dump_restart_data = app_initializer->dumpRestartData();
+    const int restart_dump_interval = app_initializer->getRestartDumpInterval();
+    const string restart_dump_dirname = app_initializer->getRestartDumpDirectory();
+
+    const bool dump_postproc_data = app_initializer->dumpPostProcessingData();
+    const int postproc_data_dump_interval = app_initializer->getPostProcessingDataDumpInterval();
+    const string postproc_data_dump_dirname = app_initializer->getPostProcessingDataDumpDirectory();
+    if (dump_postproc_data && (postproc_data_dump_interval > 0) && !postproc_data_dump_dirname.empty())
+    {
+        Utilities::recursiveMkdir(postproc_data_dump_dirname);
+    }
+
+    // The hierarchy data of the post-processing dumps are written to one SAMRAI HDF5 file per rank, or with
+    // hierarchy_dump_format = "SHARED" to a single file per dump with collective MPI-IO (see
+    // HierarchyDataWriter).
+    const string hierarchy_dump_format = input_db->getStringWithDefault("hierarchy_dump_format", "PER_RANK");
+    if (hierarchy_dump_format != "PER_RANK" && hierarchy_dump_format != "SHARED")
+    {
+        TBOX_ERROR("main(): unknown hierarchy_dump_format " << hierarchy_dump_format
+                                                            << "; valid options are PER_RANK and SHARED\n");
+    }
+    const int hierarchy_dump_num_writers = input_db->getIntegerWithDefault("hierarchy_dump_num_writers", 0);
+
+    // The Lagrangian positions of the post-processing dumps are written as ASCII text from the gathered
+    // vector, or with lagrangian_dump_format = "BINARY" in parallel to a binary file (see
+    // LagrangianDataWriter), optionally in single precision and as deltas between keyframes.
+    const string lagrangian_dump_format = input_db->getStringWithDefault("lagrangian_dump_format", "ASCII");
+    if (lagrangian_dump_format != "ASCII" && lagrangian_dump_format != "BINARY")
+    {
+        TBOX_ERROR("main(): unknown lagrangian_dump_format " << lagrangian_dump_format
+                                                             << "; valid options are ASCII and BINARY\n");
+    }
+    Pointer<LagrangianDataWriter> X_writer;
+    if (lagrangian_dump_format == "BINARY")
+    {
+        const bool use_single_precision = input_db->getBoolWithDefault("lagrangian_dump_single_precision", false);
+        const bool write_deltas = input_db->getBoolWithDefault("lagrangian_dump_deltas", false);
+        const int keyframe_interval = input_db->getIntegerWithDefault("lagrangian_dump_keyframe_interval", 10);
+        X_writer = new LagrangianDataWriter("LagrangianDataWriter",
+                                            postproc_data_dump_dirname,
+                                            use_single_precision,
+                                            write_deltas,
+                                            keyframe_interval);
+    }
+
+    const bool dump_timer_data = app_initializer->dumpTimerData();
+    const int timer_dump_interval = app_initializer->getTimerDumpInterval();
+    const string phase_breakdown_file =
+        input_db->getStringWithDefault("phase_breakdown_file", "phase_breakdown.dat");
+
+    // Create major algorithm and data objects that comprise the
+    // application.  These objects are configured from the input database
+    // and, if this is a restarted run, from the restart database.
+    Pointer<INSHierarchyIntegrator> navier_stokes_integrator = new INSStaggeredHierarchyIntegrator(
+        "INSStaggeredHierarchyIntegrator" + name_suffix,
+        app_initializer->getComponentDatabase("INSStaggeredHierarchyIntegrator"));
+
+    const int num_structures = input_db->getIntegerWithDefault("num_structures", 1);
+    Pointer<ConstraintIBMethod> ib_method_ops = new ConstraintIBMethod(
+        "ConstraintIBMethod" + name_suffix,
+        app_initializer->getComponentDatabase("ConstraintIBMethod"),
+        num_structures);
+    Pointer<IBHierarchyIntegrator> time_integrator =
+        new IBExplicitHierarchyIntegrator("IBHierarchyIntegrator" + name_suffix,
+                                          app_initializer->getComponentDatabase("IBHierarchyIntegrator"),
+                                          ib_method_ops,
+                                          navier_stokes_integrator);
+
+    Pointer<CartesianGridGeometry<NDIM> > grid_geometry = new CartesianGridGeometry<NDIM>(
+        "CartesianGeometry" + name_suffix, app_initializer->getComponentDatabase("CartesianGeometry"));
+    Pointer<PatchHierarchy<NDIM> > patch_hierarchy =
+        new PatchHierarchy<NDIM>("PatchHierarchy" + name_suffix, grid_geometry);
+
+    Pointer<StandardTagAndInitialize<NDIM> > error_detector =
+        new StandardTagAndInitialize<NDIM>("StandardTagAndInitialize" + name_suffix,
+                                           time_integrator,
+                                           app_initializer->getComponentDatabase("StandardTagAndInitialize"));
+    Pointer<BergerRigoutsos<NDIM> > box_generator = new BergerRigoutsos<NDIM>();
+    Pointer<LoadBalancer<NDIM> > load_balancer =
+        new LoadBalancer<NDIM>("LoadBalancer" + name_suffix, app_initializer->getComponentDatabase("LoadBalancer"));
+    Pointer<GriddingAlgorithm<NDIM> > gridding_algorithm =
+        new GriddingAlgorithm<NDIM>("GriddingAlgorithm" + name_suffix,
+                                    app_initializer->getComponentDatabase("GriddingAlgorithm"),
+                                    error_detector,
+                                    box_generator,
+                                    load_balancer);
+
+    // Configure the IB solver. The structure files are read when the initializer is created, relative to the
+    // directory the run was started from.
+    if (!base_dirname.empty()) change_directory(base_dirname);
+    Pointer<IBStandardInitializer> ib_initializer = new IBStandardInitializer(
+        "IBStandardInitializer" + name_suffix, app_initializer->getComponentDatabase("IBStandardInitializer"));
+    if (!base_dirname.empty()) change_directory(case_dirname);
+    ib_method_ops->registerLInitStrategy(ib_initializer);
+    Pointer<IBStandardForceGen> ib_force_fcn = new IBStandardForceGen();
+    ib_method_ops->registerIBLagrangianForceFunction(ib_force_fcn);
+
+    // Create Eulerian initial condition specification objects.
+    if (input_db->keyExists("VelocityInitialConditions"))
+    {
+        Pointer<CartGridFunction> u_init = new muParserCartGridFunction(
+            "u_init", app_initializer->getComponentDatabase("VelocityInitialConditions"), grid_geometry);
+        navier_stokes_integrator->registerVelocityInitialConditions(u_init);
+    }
+
+    if (input_db->keyExists("PressureInitialConditions"))
+    {
+        Pointer<CartGridFunction> p_init = new muParserCartGridFunction(
+            "p_init", app_initializer->getComponentDatabase("PressureInitialConditions"), grid_geometry);
+        navier_stokes_integrator->registerPressureInitialConditions(p_init);
+    }
+
+    // Create Eulerian boundary condition specification objects (when necessary).
+    const IntVector<NDIM>& periodic_shift = grid_geometry->getPeriodicShift();
+    vector<RobinBcCoefStrategy<NDIM>*> u_bc_coefs(NDIM);
+    if (periodic_shift.min() > 0)
+    {
+        for (unsigned int d = 0; d < NDIM; ++d)
         {
-            ib_initializer->registerLSiloDataWriter(silo_data_writer);
-            ib_method_ops->registerLSiloDataWriter(silo_data_writer);
-            time_integrator->registerVisItDataWriter(visit_data_writer);
+            u_bc_coefs[d] = nullptr;
         }
+    }
+    else
+    {
+        for (unsigned int d = 0; d < NDIM; ++d)
+        {
+            const std::string bc_coefs_name = "u_bc_coefs_" + std::to_string(d);
 
-        // Initialize hierarchy configuration and data on all patches.
-        time_integrator->initializePatchHierarchy(patch_hierarchy, gridding_algorithm);
-
-        // Create ConstraintIBKinematics objects
-        vector<Pointer<ConstraintIBKinematics> > ibkinematics_ops_vec;
-        Pointer<ConstraintIBKinematics> ib_kinematics_op;
-        // struct_0
-        ib_kinematics_op =
-            new IBEELKinematics("eel2d",
-                                app_initializer->getComponentDatabase("ConstraintIBKinematics")->getDatabase("eel2d"),
-                                ib_method_ops->getLDataManager(),
-                                patch_hierarchy);
-        ibkinematics_ops_vec.push_back(ib_kinematics_op);
-
-        // register ConstraintIBKinematics objects with ConstraintIBMethod.
-        ib_method_ops->registerConstraintIBKinematics(ibkinematics_ops_vec);
-        ib_method_ops->initializeHierarchyOperatorsandData();
+            const std::string bc_coefs_db_name = "VelocityBcCoefs_" + std::to_string(d);
 
-        // Create hydrodynamic force evaluator object.
-        double rho_fluid = input_db->getDouble("RHO");
-        double mu_fluid = input_db->getDouble("MU");
-        double start_time = time_integrator->getIntegratorTime();
-        Pointer<IBHydrodynamicForceEvaluator> hydro_force =
-            new IBHydrodynamicForceEvaluator("IBHydrodynamicForce", rho_fluid, mu_fluid, start_time, true);
+            u_bc_coefs[d] = new muParserRobinBcCoefs(
+                bc_coefs_name, app_initializer->getComponentDatabase(bc_coefs_db_name), grid_geometry);
+        }
+        navier_stokes_integrator->registerPhysicalBoundaryConditions(u_bc_coefs);
+    }
+
+    // Create Eulerian body force function specification objects.
+    if (input_db->keyExists("ForcingFunction"))
+    {
+        Pointer<CartGridFunction> f_fcn = new muParserCartGridFunction(
+            "f_fcn", app_initializer->getComponentDatabase("ForcingFunction"), grid_geometry);
+        time_integrator->registerBodyForceFunction(f_fcn);
+    }
+
+    // Set up visualization plot file writers.
+    Pointer<VisItDataWriter<NDIM> > visit_data_writer = app_initializer->getVisItDataWriter();
+    Pointer<LSiloDataWriter> silo_data_writer = app_initializer->getLSiloDataWriter();
+    if (uses_visit)
+    {
+        ib_initializer->registerLSiloDataWriter(silo_data_writer);
+        ib_method_ops->registerLSiloDataWriter(silo_data_writer);
+        time_integrator->registerVisItDataWriter(visit_data_writer);
+    }
+
+    // Initialize hierarchy configuration and data on all patches.
+    time_integrator->initializePatchHierarchy(patch_hierarchy, gridding_algorithm);
+
+    // Create ConstraintIBKinematics objects, one per structure, in the order of the structures of the
+    // IBStandardInitializer. Each structure has a sub-database of the same name in ConstraintIBKinematics.
+    Pointer<Database> kinematics_db = app_initializer->getComponentDatabase("ConstraintIBKinematics");
+    const Array<string> structure_names =
+        app_initializer->getComponentDatabase("IBStandardInitializer")->getStringArray("structure_names");
+    if (structure_names.getSize() != num_structures)
+    {
+        TBOX_ERROR("main(): num_structures = " << num_structures << " but IBStandardInitializer has "
+                                               << structure_names.getSize() << " structure_names\n");
+    }
+    vector<Pointer<ConstraintIBKinematics> > ibkinematics_ops_vec;
+    vector<Pointer<IBEELKinematics> > eel_kinematics(num_structures);
+    vector<IBEELKinematics*> school(num_structures);
+    for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+    {
+        const string& name = structure_names[struct_id];
+        if (!kinematics_db->isDatabase(name))
+        {
+            TBOX_ERROR("main(): no ConstraintIBKinematics database for structure " << name << "\n");
+        }
+        eel_kinematics[struct_id] = new IBEELKinematics(
+            name, kinematics_db->getDatabase(name), ib_method_ops->getLDataManager(), patch_hierarchy);
+        school[struct_id] = eel_kinematics[struct_id].getPointer();
+        ibkinematics_ops_vec.push_back(eel_kinematics[struct_id]);
 
-        // Get the initial box position and velocity from input
-        const string init_hydro_force_box_db_name = "InitHydroForceBox_0";
+        // Each swimmer logs its own performance metrics.
+        for (int other_id = 0; other_id < struct_id; ++other_id)
+        {
+            if (eel_kinematics[other_id]->getPerformanceLogFile() ==
+                eel_kinematics[struct_id]->getPerformanceLogFile())
+            {
+                TBOX_ERROR("main(): structures " << structure_names[other_id] << " and " << name
+                                                 << " share performance_log_file "
+                                                 << eel_kinematics[struct_id]->getPerformanceLogFile() << "\n");
+            }
+        }
+    }
+
+    // register ConstraintIBKinematics objects with ConstraintIBMethod.
+    ib_method_ops->registerConstraintIBKinematics(ibkinematics_ops_vec);
+    ib_method_ops->initializeHierarchyOperatorsandData();
+
+    // Hydrodynamic forces are sampled every force_sample_interval steps, or, when force_sample_period is
+    // positive, on the first step past each multiple of force_sample_period, and at the end of the run.
+    const int force_sample_interval = input_db->getIntegerWithDefault("force_sample_interval", 1);
+    const double force_sample_period = input_db->getDoubleWithDefault("force_sample_period", 0.0);
+    if (force_sample_interval < 1)
+    {
+        TBOX_ERROR("main(): force_sample_interval = " << force_sample_interval << " must be positive\n");
+    }
+
+    // With force_evaluation = "LAGRANGE_MULTIPLIER", the forces are instead computed at every step from the
+    // constraint forces on the Lagrangian points (see LagrangeMultiplierForceEvaluator), and the control
+    // volume forces only every force_cross_check_interval steps (never when 0), to compare the two.
+    const string force_evaluation = input_db->getStringWithDefault("force_evaluation", "CONTROL_VOLUME");
+    if (force_evaluation != "CONTROL_VOLUME" && force_evaluation != "LAGRANGE_MULTIPLIER")
+    {
+        TBOX_ERROR("main(): unknown force_evaluation " << force_evaluation
+                                                       << "; valid options are CONTROL_VOLUME and "
+                                                          "LAGRANGE_MULTIPLIER\n");
+    }
+    const bool uses_lm_force = force_evaluation == "LAGRANGE_MULTIPLIER";
+    const int force_cross_check_interval = input_db->getIntegerWithDefault("force_cross_check_interval", 0);
+
+    // With stop_at_periodic_steady_state, the run ends once the cycle averages of every swimmer (see
+    // CycleStatistics) have changed by at most steady_state_tolerance, relative to their size, between
+    // steady_state_cycles + 1 consecutive tail-beat cycles. The usual end-of-run output is then written.
+    const bool stop_at_steady_state = input_db->getBoolWithDefault("stop_at_periodic_steady_state", false);
+    const double steady_state_tolerance = input_db->getDoubleWithDefault("steady_state_tolerance", 0.01);
+    const int steady_state_cycles = input_db->getIntegerWithDefault("steady_state_cycles", 3);
+    if (steady_state_cycles < 1)
+    {
+        TBOX_ERROR("main(): steady_state_cycles = " << steady_state_cycles << " must be positive\n");
+    }
+    for (int struct_id = 0; struct_id < num_structures && stop_at_steady_state; ++struct_id)
+    {
+        if (!eel_kinematics[struct_id]->isTrackingPerformance())
+        {
+            TBOX_ERROR("main(): stop_at_periodic_steady_state needs the cycle statistics of every structure, but "
+                       << structure_names[struct_id] << " sets track_performance = FALSE\n");
+        }
+    }
+
+    // Create hydrodynamic force evaluator object.
+    double rho_fluid = input_db->getDouble("RHO");
+    double mu_fluid = input_db->getDouble("MU");
+    double start_time = time_integrator->getIntegratorTime();
+    Pointer<IBHydrodynamicForceEvaluator> hydro_force =
+        new IBHydrodynamicForceEvaluator("IBHydrodynamicForce" + name_suffix, rho_fluid, mu_fluid, start_time, true);
+    Pointer<LagrangeMultiplierForceEvaluator> lm_force;
+    if (uses_lm_force)
+    {
+        std::vector<std::pair<int, int> > lag_idx_ranges(num_structures);
+        std::vector<double> vol_elements(num_structures);
+        for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+        {
+            lag_idx_ranges[struct_id] = eel_kinematics[struct_id]->getStructureParameters().getLagIdxRange()[0];
+            vol_elements[struct_id] = eel_kinematics[struct_id]->getVolumeElement();
+        }
+        lm_force = new LagrangeMultiplierForceEvaluator(
+            "LagrangeMultiplierForce" + name_suffix,
+            rho_fluid,
+            start_time,
+            lag_idx_ranges,
+            vol_elements,
+            input_db->getStringWithDefault("lagrange_multiplier_force_file", "lagrange_multiplier_force.dat"));
+    }
+
+    // Register a control volume around each structure, with its initial position and velocity from input,
+    // and set the torque evaluation axis to point from its newest COM. With track_body = TRUE, the control
+    // volume is instead the bounding box of the body enlarged by body_margin on each side and rounded out to
+    // coarse grid lines, and it follows the body in all directions (see the time step loop).
+    std::vector<std::vector<double> > structure_COM = ib_method_ops->getCurrentStructureCOM();
+    const double* const grid_x_lower = grid_geometry->getXLower();
+    const double* const grid_dx = grid_geometry->getDx();
+    std::vector<bool> cv_tracks_body(num_structures, false), cv_warned(num_structures, false);
+    std::vector<IBTK::Vector3d> cv_X_lower(num_structures), cv_X_upper(num_structures);
+    std::vector<IBTK::Vector3d> body_X_lower, body_X_upper;
+    compute_structure_bounding_boxes(ib_method_ops->getLDataManager(),
+                                     eel_kinematics,
+                                     patch_hierarchy->getFinestLevelNumber(),
+                                     body_X_lower,
+                                     body_X_upper);
+    for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+    {
+        const string init_hydro_force_box_db_name = "InitHydroForceBox_" + std::to_string(struct_id);
+        Pointer<Database> box_db = input_db->getDatabase(init_hydro_force_box_db_name);
         IBTK::Vector3d box_X_lower, box_X_upper, box_init_vel;
 
-        input_db->getDatabase(init_hydro_force_box_db_name)->getDoubleArray("lower_left_corner", &box_X_lower[0], 3);
-        input_db->getDatabase(init_hydro_force_box_db_name)->getDoubleArray("upper_right_corner", &box_X_upper[0], 3);
-        input_db->getDatabase(init_hydro_force_box_db_name)->getDoubleArray("init_velocity", &box_init_vel[0], 3);
+        cv_tracks_body[struct_id] = box_db->getBoolWithDefault("track_body", false);
+        if (cv_tracks_body[struct_id])
+        {
+            const double margin = box_db->getDouble("body_margin");
+            box_X_lower.setZero();
+            box_X_upper.setZero();
+            box_init_vel.setZero();
+            for (int d = 0; d < NDIM; ++d)
+            {
+                box_X_lower[d] =
+                    grid_x_lower[d] +
+                    std::floor((body_X_lower[struct_id][d] - margin - grid_x_lower[d]) / grid_dx[d]) * grid_dx[d];
+                box_X_upper[d] =
+                    grid_x_lower[d] +
+                    std::ceil((body_X_upper[struct_id][d] + margin - grid_x_lower[d]) / grid_dx[d]) * grid_dx[d];
+            }
+            pout << "Control volume of structure " << struct_id << ": [" << box_X_lower[0] << ", "
+                 << box_X_upper[0] << "] x [" << box_X_lower[1] << ", " << box_X_upper[1] << "]\n";
+        }
+        else
+        {
+            box_db->getDoubleArray("lower_left_corner", &box_X_lower[0], 3);
+            box_db->getDoubleArray("upper_right_corner", &box_X_upper[0], 3);
+            box_db->getDoubleArray("init_velocity", &box_init_vel[0], 3);
+        }
+        cv_X_lower[struct_id] = box_X_lower;
+        cv_X_upper[struct_id] = box_X_upper;
 
-        // Register control volume
-        hydro_force->registerStructure(box_X_lower, box_X_upper, patch_hierarchy, box_init_vel, 0);
+        hydro_force->registerStructure(box_X_lower, box_X_upper, patch_hierarchy, box_init_vel, struct_id);
 
-        // Create COM variable
-        std::vector<std::vector<double> > structure_COM = ib_method_ops->getCurrentStructureCOM();
         IBTK::Vector3d eel_COM;
-        for (int d = 0; d < 3; ++d) eel_COM[d] = structure_COM[0][d];
-
-        // Set the torque evaluation axis to point from newest COM
-        hydro_force->setTorqueOrigin(eel_COM, 0);
+        for (int d = 0; d < 3; ++d) eel_COM[d] = structure_COM[struct_id][d];
+        hydro_force->setTorqueOrigin(eel_COM, struct_id);
 
         // Register optional plot data
-        hydro_force->registerStructurePlotData(visit_data_writer, patch_hierarchy, 0);
+        hydro_force->registerStructurePlotData(visit_data_writer, patch_hierarchy, struct_id);
+    }
 
-        // Deallocate initialization objects.
-        ib_method_ops->freeLInitStrategy();
-        ib_initializer.setNull();
-        app_initializer.setNull();
+    // Deallocate initialization objects.
+    ib_method_ops->freeLInitStrategy();
+    ib_initializer.setNull();
+    app_initializer.setNull();
 
-        // Print the input database contents to the log file.
-        plog << "Input database:\n";
-        input_db->printClassData(plog);
+    // Print the input database contents to the log file.
+    plog << "Input database:\n";
+    input_db->printClassData(plog);
 
-        // Get velocity and pressure variables from integrator
-        VariableDatabase<NDIM>* var_db = VariableDatabase<NDIM>::getDatabase();
-
-        const Pointer<Variable<NDIM> > u_var = navier_stokes_integrator->getVelocityVariable();
-        const Pointer<VariableContext> u_ctx = navier_stokes_integrator->getCurrentContext();
-        const int u_idx = var_db->mapVariableAndContextToIndex(u_var, u_ctx);
-
-        const Pointer<Variable<NDIM> > p_var = navier_stokes_integrator->getPressureVariable();
-        const Pointer<VariableContext> p_ctx = navier_stokes_integrator->getCurrentContext();
-        const int p_idx = var_db->mapVariableAndContextToIndex(p_var, p_ctx);
+    // Get velocity and pressure variables from integrator
+    VariableDatabase<NDIM>* var_db = VariableDatabase<NDIM>::getDatabase();
 
-        // Write out initial visualization data.
-        int iteration_num = time_integrator->getIntegratorStep();
-        double loop_time = time_integrator->getIntegratorTime();
-        if (dump_viz_data && uses_visit)
+    const Pointer<Variable<NDIM> > u_var = navier_stokes_integrator->getVelocityVariable();
+    const Pointer<VariableContext> u_ctx = navier_stokes_integrator->getCurrentContext();
+    const int u_idx = var_db->mapVariableAndContextToIndex(u_var, u_ctx);
+
+    const Pointer<Variable<NDIM> > p_var = navier_stokes_integrator->getPressureVariable();
+    const Pointer<VariableContext> p_ctx = navier_stokes_integrator->getCurrentContext();
+    const int p_idx = var_db->mapVariableAndContextToIndex(p_var, p_ctx);
+
+    // The asynchronous writer always writes the velocity and the pressure, and the current data of the
+    // variables named in async_viz_variables (e.g. "INSStaggeredHierarchyIntegrator::Omega"; in a sweep case,
+    // the name of the object is followed by the case suffix).
+    Pointer<AsyncPlotDataWriter> async_viz_writer;
+    if (uses_async_viz)
+    {
+        async_viz_writer = new AsyncPlotDataWriter("AsyncPlotDataWriter", viz_dump_dirname);
+        async_viz_writer->registerPlotData("U", u_idx);
+        async_viz_writer->registerPlotData("P", p_idx);
+        if (input_db->keyExists("async_viz_variables"))
         {
-            pout << "\n\nWriting visualization files...\n\n";
-            time_integrator->setupPlotData();
-            visit_data_writer->writePlotData(patch_hierarchy, iteration_num, loop_time);
-            silo_data_writer->writePlotData(iteration_num, loop_time);
+            const Array<string> var_names = input_db->getStringArray("async_viz_variables");
+            for (int k = 0; k < var_names.getSize(); ++k)
+            {
+                string var_name = var_names[k];
+                const string::size_type object_name_end = var_name.find("::");
+                if (object_name_end != string::npos) var_name.insert(object_name_end, name_suffix);
+                const Pointer<Variable<NDIM> > var = var_db->getVariable(var_name);
+                int idx = -1;
+                if (!var.isNull())
+                {
+                    idx = var_db->mapVariableAndContextToIndex(var, navier_stokes_integrator->getCurrentContext());
+                }
+                if (idx < 0)
+                {
+                    TBOX_ERROR("main(): async_viz_variables entry " << var_names[k]
+                                                                    << " has no current data\n");
+                }
+                async_viz_writer->registerPlotData(var_names[k], idx);
+            }
         }
-
-        // Main time step loop.
-        double loop_time_end = time_integrator->getEndTime();
-        double dt = 0.0;
-        double current_time, new_time;
-        double box_disp = 0.0;
-        while (!IBTK::rel_equal_eps(loop_time, loop_time_end) && time_integrator->stepsRemaining())
+    }
+
+    Pointer<HierarchyDataWriter> hier_writer;
+    if (hierarchy_dump_format == "SHARED")
+    {
+        hier_writer =
+            new HierarchyDataWriter("HierarchyDataWriter", postproc_data_dump_dirname, hierarchy_dump_num_writers);
+        hier_writer->registerPatchData("U", u_idx);
+        hier_writer->registerPatchData("P", p_idx);
+    }
+
+    // Write out initial visualization data.
+    int iteration_num = time_integrator->getIntegratorStep();
+    double loop_time = time_integrator->getIntegratorTime();
+    if (uses_async_viz)
+    {
+        pout << "\n\nWriting visualization files in the background...\n\n";
+        time_integrator->setupPlotData();
+        async_viz_writer->writePlotData(
+            patch_hierarchy, ib_method_ops->getLDataManager(), iteration_num, loop_time);
+    }
+    else if (dump_viz_data && uses_visit)
+    {
+        pout << "\n\nWriting visualization files...\n\n";
+        time_integrator->setupPlotData();
+        visit_data_writer->writePlotData(patch_hierarchy, iteration_num, loop_time);
+        silo_data_writer->writePlotData(iteration_num, loop_time);
+    }
+
+    // Timers of the driver phases. The time spent per step in these and in the kinematics phases is recorded
+    // in the phase breakdown file (one row per step, columns as in PHASE_TIMER_NAMES) when timer data is
+    // dumped.
+    TimerManager* timer_manager = TimerManager::getManager();
+    Pointer<Timer> t_time_step = timer_manager->getTimer("eel2d::main::timeStep()");
+    Pointer<Timer> t_advance_hierarchy = timer_manager->getTimer("eel2d::main::advanceHierarchy()");
+    Pointer<Timer> t_compute_lagged_momentum_integral =
+        timer_manager->getTimer("eel2d::main::computeLaggedMomentumIntegral()");
+    Pointer<Timer> t_compute_hydrodynamic_force =
+        timer_manager->getTimer("eel2d::main::computeHydrodynamicForce()");
+    Pointer<Timer> t_compute_lm_force = timer_manager->getTimer("eel2d::main::computeLagrangeMultiplierForce()");
+    Pointer<Timer> t_write_plot_data = timer_manager->getTimer("eel2d::main::writePlotData()");
+    static const char* const PHASE_TIMER_NAMES[] = { "eel2d::main::timeStep()",
+                                                     "eel2d::main::advanceHierarchy()",
+                                                     "IBAMR::IBEELKinematics::setKinematicsVelocity()",
+                                                     "IBAMR::IBEELKinematics::calculateAdaptiveKinematics()",
+                                                     "IBAMR::IBEELKinematics::setSectionVelocity()",
+                                                     "IBAMR::IBEELKinematics::setShape()",
+                                                     "IBAMR::IBEELKinematics::setSectionShape()",
+                                                     "IBAMR::IBEELKinematics::transformShape()",
+                                                     "eel2d::main::computeLaggedMomentumIntegral()",
+                                                     "eel2d::main::computeHydrodynamicForce()",
+                                                     "eel2d::main::computeLagrangeMultiplierForce()",
+                                                     "eel2d::main::writePlotData()" };
+    const int num_phases = sizeof(PHASE_TIMER_NAMES) / sizeof(PHASE_TIMER_NAMES[0]);
+    std::vector<Pointer<Timer> > phase_timers(num_phases);
+    std::vector<double> phase_wallclock_time(num_phases, 0.0);
+    std::vector<double> phase_row(2 + num_phases);
+    for (int k = 0; k < num_phases; ++k)
+    {
+        phase_timers[k] = timer_manager->getTimer(PHASE_TIMER_NAMES[k]);
+        phase_wallclock_time[k] = phase_timers[k]->getTotalWallclockTime();
+    }
+    PerformanceMetricsWriter phase_writer;
+    if (dump_timer_data && IBTK_MPI::getRank() == 0)
+    {
+        std::ostringstream header;
+        header << "# Wall-clock seconds per time step spent in each phase\n";
+        header << "# Columns: time step";
+        for (int k = 0; k < num_phases; ++k) header << " " << PHASE_TIMER_NAMES[k];
+        header << "\n";
+        phase_writer.open(phase_breakdown_file,
+                          header.str(),
+                          2 + num_phases,
+                          RestartManager::getManager()->isFromRestart(),
+                          loop_time,
+                          /*flush_rows*/ 64,
+                          /*flush_interval*/ 5.0);
+    }
+
+    // Every entry replaced by the case must have been read while setting it up, or the case would silently
+    // run with the values of the input file.
+    if (!case_db.isNull()) check_case_overrides_read(input_db, case_db, "");
+
+    // Main time step loop.
+    double loop_time_end = time_integrator->getEndTime();
+    double dt = 0.0;
+    double current_time, new_time;
+    std::vector<double> box_disp(num_structures, 0.0);
+    std::vector<IBTK::Vector3d> cv_pending_disp(num_structures, IBTK::Vector3d::Zero());
+    // Structure momenta of the previous step, starting from those the evaluator holds (see the time step loop).
+    std::vector<IBTK::Vector3d> previous_eel_mom(num_structures), previous_eel_rot_mom(num_structures);
+    for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+    {
+        previous_eel_mom[struct_id] = hydro_force->getHydrodynamicForceObject(struct_id).P_current;
+        previous_eel_rot_mom[struct_id] = hydro_force->getHydrodynamicForceObject(struct_id).L_current;
+    }
+    static const int NUM_STEADY_STATE_VALUES = 3;
+    std::vector<int> cycles_checked(num_structures, 0), steady_cycle_count(num_structures, 0);
+    std::vector<std::vector<double> > previous_cycle_values(num_structures,
+                                                            std::vector<double>(NUM_STEADY_STATE_VALUES, 0.0));
+    bool reached_steady_state = false;
+    while (!IBTK::rel_equal_eps(loop_time, loop_time_end) && time_integrator->stepsRemaining())
+    {
+        iteration_num = time_integrator->getIntegratorStep();
+        loop_time = time_integrator->getIntegratorTime();
+        current_time = loop_time;
+        t_time_step->start();
+
+        pout << "\n";
+        pout << "+++++++++++++++++++++++++++++++++++++++++++++++++++\n";
+        pout << "At beginning of timestep # " << iteration_num << "\n";
+        pout << "Simulation time is " << loop_time << "\n";
+
+        dt = time_integrator->getMaximumTimeStepSize();
+        loop_time += dt;
+        new_time = loop_time;
+
+        // Regrid the hierarchy if necessary.
+        if (time_integrator->atRegridPoint()) time_integrator->regridHierarchy();
+
+        int coarsest_ln = 0;
+        Pointer<PatchLevel<NDIM> > coarsest_level = patch_hierarchy->getPatchLevel(coarsest_ln);
+        const Pointer<CartesianGridGeometry<NDIM> > coarsest_grid_geom = coarsest_level->getGridGeometry();
+        const double* const DX = coarsest_grid_geom->getDx();
+
+        // The control-volume force pipeline runs on the force sampling steps only. In between, the motion of
+        // each control volume is accumulated and applied for time n + 1 of the following sampling steps, so that
+        // the lagged momentum integral of a sampling step pairs u^n and u^(n+1) in the same box.
+        // With Lagrange multiplier forces, the sampling steps are the cross-check steps.
+        bool sample_forces = (iteration_num + 1) % force_sample_interval == 0;
+        if (force_sample_period > 0.0)
         {
-            iteration_num = time_integrator->getIntegratorStep();
-            loop_time = time_integrator->getIntegratorTime();
-            current_time = loop_time;
-
-            pout << "\n";
-            pout << "+++++++++++++++++++++++++++++++++++++++++++++++++++\n";
-            pout << "At beginning of timestep # " << iteration_num << "\n";
-            pout << "Simulation time is " << loop_time << "\n";
-
-            dt = time_integrator->getMaximumTimeStepSize();
-            loop_time += dt;
-            new_time = loop_time;
-
-            // Regrid the hierarchy if necessary.
-            if (time_integrator->atRegridPoint()) time_integrator->regridHierarchy();
-
-            // Set the box velocity to nonzero only if the eel has moved sufficiently far.
-            IBTK::Vector3d box_vel;
-            box_vel.setZero();
-
-            // Velocity due to free-swimming
-            std::vector<std::vector<double> > COM_vel = ib_method_ops->getCurrentCOMVelocity();
-            for (int d = 0; d < NDIM; ++d) box_vel(d) = COM_vel[0][d];
-
-            int coarsest_ln = 0;
-            Pointer<PatchLevel<NDIM> > coarsest_level = patch_hierarchy->getPatchLevel(coarsest_ln);
-            const Pointer<CartesianGridGeometry<NDIM> > coarsest_grid_geom = coarsest_level->getGridGeometry();
-            const double* const DX = coarsest_grid_geom->getDx();
-
-            // Set the box velocity to ensure that the immersed body remains inside the control volume at all times.
-            // If the body's COM has moved 0.9 coarse mesh widths in the x-direction, set the CV velocity such that
-            // the CV will translate by 1 coarse mesh width in the direction of swimming (negative x-direction).
-            // Otherwise, keep the CV in place by setting its velocity to zero.
+            sample_forces = std::floor(new_time / force_sample_period + 1.0e-8) >
+                            std::floor(current_time / force_sample_period + 1.0e-8);
+        }
+        sample_forces = sample_forces || IBTK::rel_equal_eps(new_time, loop_time_end);
+        if (uses_lm_force)
+        {
+            sample_forces = force_cross_check_interval > 0 && (iteration_num + 1) % force_cross_check_interval == 0;
+        }
 
-            box_disp += box_vel[0] * dt;
-            if (abs(box_disp) >= abs(0.9 * DX[0]))
+        // Velocity due to free-swimming
+        std::vector<std::vector<double> > COM_vel = ib_method_ops->getCurrentCOMVelocity();
+        if (sample_forces && std::find(cv_tracks_body.begin(), cv_tracks_body.end(), true) != cv_tracks_body.end())
+        {
+            compute_structure_bounding_boxes(ib_method_ops->getLDataManager(),
+                                             eel_kinematics,
+                                             patch_hierarchy->getFinestLevelNumber(),
+                                             body_X_lower,
+                                             body_X_upper);
+        }
+        for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+        {
+            if (cv_tracks_body[struct_id] && sample_forces)
             {
-                box_vel.setZero();
-                box_vel[0] = -DX[0] / dt;
-
-                box_disp = 0.0;
+                // Move the control volume by the whole number of coarse mesh widths that best centers it on
+                // the bounding box of the body, extrapolated to time n + 1 with the COM velocity. The motion
+                // still pending from previous samples is part of the move.
+                for (int d = 0; d < NDIM; ++d)
+                {
+                    const double drift =
+                        0.5 * (body_X_lower[struct_id][d] + body_X_upper[struct_id][d]) + COM_vel[struct_id][d] * dt -
+                        0.5 * (cv_X_lower[struct_id][d] + cv_X_upper[struct_id][d]) - cv_pending_disp[struct_id][d];
+                    cv_pending_disp[struct_id][d] += std::round(drift / DX[d]) * DX[d];
+                }
             }
-            else
+            else if (!cv_tracks_body[struct_id])
             {
-                box_vel.setZero();
+                // Keep the immersed body inside the control volume at all times. If the body's COM has moved
+                // 0.9 coarse mesh widths in the x-direction, translate the CV by 1 coarse mesh width in the
+                // direction of swimming (negative x-direction). Otherwise, keep the CV in place.
+                box_disp[struct_id] += COM_vel[struct_id][0] * dt;
+                if (abs(box_disp[struct_id]) >= abs(0.9 * DX[0]))
+                {
+                    cv_pending_disp[struct_id][0] -= DX[0];
+                    box_disp[struct_id] = 0.0;
+                }
             }
 
-            // Update the location of the box for time n + 1
-            hydro_force->updateStructureDomain(box_vel, dt, patch_hierarchy, 0);
+            // Update the location of the box for time n + 1. The evaluator also takes the displacement over dt
+            // as the box velocity in the momentum flux through the box faces, so a sampling step moves the box by
+            // at most one coarse mesh width per direction, as a step of the unsampled pipeline does, and the rest
+            // of the accumulated motion is carried over to the next samples.
+            if (sample_forces)
+            {
+                IBTK::Vector3d box_disp_new = IBTK::Vector3d::Zero();
+                for (int d = 0; d < NDIM; ++d)
+                {
+                    box_disp_new[d] = std::max(-DX[d], std::min(DX[d], cv_pending_disp[struct_id][d]));
+                }
+                IBTK::Vector3d box_vel = box_disp_new / dt;
+                hydro_force->updateStructureDomain(box_vel, dt, patch_hierarchy, struct_id);
+                cv_pending_disp[struct_id] -= box_disp_new;
+                cv_X_lower[struct_id] += box_disp_new;
+                cv_X_upper[struct_id] += box_disp_new;
+            }
+            if (cv_tracks_body[struct_id] && sample_forces)
+            {
+                bool body_inside = true;
+                for (int d = 0; d < NDIM; ++d)
+                {
+                    const double body_shift = COM_vel[struct_id][d] * dt;
+                    if (body_X_lower[struct_id][d] + body_shift <= cv_X_lower[struct_id][d] ||
+                        body_X_upper[struct_id][d] + body_shift >= cv_X_upper[struct_id][d])
+                    {
+                        body_inside = false;
+                    }
+                }
+                if (!body_inside && !cv_warned[struct_id])
+                {
+                    TBOX_WARNING("main(): structure " << struct_id << " extends past its control volume at time "
+                                                      << loop_time << "; increase body_margin or sample more often\n");
+                    cv_warned[struct_id] = true;
+                }
+            }
+        }
 
-            // Compute the momentum of u^n in box n+1 on the newest hierarchy
+        // Compute the momentum of u^n in box n+1 on the newest hierarchy
+        if (sample_forces)
+        {
+            t_compute_lagged_momentum_integral->start();
             hydro_force->computeLaggedMomentumIntegral(
                 u_idx, patch_hierarchy, navier_stokes_integrator->getVelocityBoundaryConditions());
+            t_compute_lagged_momentum_integral->stop();
+        }
 
-            // Advance the hierarchy
-            time_integrator->advanceHierarchy(dt);
+        // Evaluate the body-frame deformation of all swimmers at the new time in one pass
+        IBEELKinematics::updateSchoolDeformation(school, new_time);
 
-            pout << "\n";
-            pout << "At end       of timestep # " << iteration_num << "\n";
-            pout << "Simulation time is " << loop_time << "\n";
-            pout << "+++++++++++++++++++++++++++++++++++++++++++++++++++\n";
-            pout << "\n";
+        // Advance the hierarchy
+        t_advance_hierarchy->start();
+        time_integrator->advanceHierarchy(dt);
+        t_advance_hierarchy->stop();
 
-            // Get the momentum of the eel
+        // Compute the thrust, power and swimming speed of each swimmer from the constraint forces of this step
+        COM_vel = ib_method_ops->getCurrentCOMVelocity();
+        for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+        {
+            eel_kinematics[struct_id]->updatePerformanceMetrics(loop_time, dt, rho_fluid, COM_vel[struct_id]);
+        }
+
+        // Compare the averages of each newly completed tail-beat cycle, the mean swimming speed and the mean
+        // and fluctuation of the thrust, with those of the previous cycle. The cycle statistics are the same
+        // on all ranks, so all ranks reach the same decision.
+        if (stop_at_steady_state)
+        {
+            bool all_steady = true;
+            for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+            {
+                const CycleStatistics& stats = eel_kinematics[struct_id]->getCycleStatistics();
+                const int num_cycles = stats.getNumberOfCompletedCycles();
+                if (num_cycles > cycles_checked[struct_id])
+                {
+                    const double values[NUM_STEADY_STATE_VALUES] = {
+                        stats.getCompletedCycle(CycleStatistics::SWIMMING_SPEED).getMean(),
+                        stats.getCompletedCycle(CycleStatistics::THRUST).getMean(),
+                        stats.getCompletedCycle(CycleStatistics::THRUST).getStandardDeviation()
+                    };
+                    double max_change = 0.0;
+                    for (int k = 0; k < NUM_STEADY_STATE_VALUES; ++k)
+                    {
+                        const double previous = previous_cycle_values[struct_id][k];
+                        const double scale = std::max(std::abs(values[k]), std::abs(previous));
+                        if (scale > 0.0) max_change = std::max(max_change, std::abs(values[k] - previous) / scale);
+                        previous_cycle_values[struct_id][k] = values[k];
+                    }
+                    if (cycles_checked[struct_id] > 0 && max_change <= steady_state_tolerance)
+                    {
+                        ++steady_cycle_count[struct_id];
+                    }
+                    else
+                    {
+                        steady_cycle_count[struct_id] = 0;
+                    }
+                    cycles_checked[struct_id] = num_cycles;
+                    pout << "Structure " << struct_id << " completed tail-beat cycle " << num_cycles
+                         << ": relative change of the cycle averages " << max_change << ", "
+                         << steady_cycle_count[struct_id] << " of " << steady_state_cycles
+                         << " steady cycles\n";
+                }
+                all_steady = all_steady && steady_cycle_count[struct_id] >= steady_state_cycles;
+            }
+            reached_steady_state = all_steady;
+        }
+
+        pout << "\n";
+        pout << "At end       of timestep # " << iteration_num << "\n";
+        pout << "Simulation time is " << loop_time << "\n";
+        pout << "+++++++++++++++++++++++++++++++++++++++++++++++++++\n";
+        pout << "\n";
+
+        // Get the momentum of the eels. The evaluator takes the structure inertia as (P_new - P_current) / dt,
+        // but P_current only advances in postprocessIntegrateData(), i.e. on the sampling steps, so it holds the
+        // momentum of the previous sample. The momenta are therefore recorded at every step, and a sampling step
+        // passes P_current + (P^(n+1) - P^n), which makes the difference that of this step alone.
+        std::vector<std::vector<double> > structure_linear_momentum = ib_method_ops->getStructureMomentum();
+        std::vector<std::vector<double> > structure_rotational_momentum =
+            ib_method_ops->getStructureRotationalMomentum();
+        for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+        {
             IBTK::Vector3d eel_mom, eel_rot_mom;
             eel_mom.setZero();
             eel_rot_mom.setZero();
-            std::vector<std::vector<double> > structure_linear_momentum = ib_method_ops->getStructureMomentum();
-            for (int d = 0; d < NDIM; ++d) eel_mom[d] = structure_linear_momentum[0][d];
-            std::vector<std::vector<double> > structure_rotational_momentum =
-                ib_method_ops->getStructureRotationalMomentum();
-            for (int d = 0; d < 3; ++d) eel_rot_mom[d] = structure_rotational_momentum[0][d];
+            for (int d = 0; d < NDIM; ++d) eel_mom[d] = structure_linear_momentum[struct_id][d];
+            for (int d = 0; d < 3; ++d) eel_rot_mom[d] = structure_rotational_momentum[struct_id][d];
+            if (sample_forces)
+            {
+                const IBHydrodynamicForceEvaluator::IBHydrodynamicForceObject& force_obj =
+                    hydro_force->getHydrodynamicForceObject(struct_id);
+                hydro_force->updateStructureMomentum(force_obj.P_current + (eel_mom - previous_eel_mom[struct_id]),
+                                                     force_obj.L_current +
+                                                         (eel_rot_mom - previous_eel_rot_mom[struct_id]),
+                                                     struct_id);
+            }
+            previous_eel_mom[struct_id] = eel_mom;
+            previous_eel_rot_mom[struct_id] = eel_rot_mom;
+        }
 
-            // Store the new momenta of the eel
-            hydro_force->updateStructureMomentum(eel_mom, eel_rot_mom, 0);
+        // Evaluate the hydrodynamic force on the eels from the Lagrange multipliers.
+        if (uses_lm_force)
+        {
+            t_compute_lm_force->start();
+            lm_force->computeHydrodynamicForce(ib_method_ops->getLDataManager(),
+                                               patch_hierarchy->getFinestLevelNumber(),
+                                               dt,
+                                               ib_method_ops->getCurrentStructureCOM(),
+                                               structure_linear_momentum,
+                                               structure_rotational_momentum);
+            lm_force->writeForces(new_time);
+            t_compute_lm_force->stop();
+        }
 
-            // Evaluate hydrodynamic force on the eel.
+        // Evaluate hydrodynamic force on the eel.
+        if (sample_forces)
+        {
+            t_compute_hydrodynamic_force->start();
             hydro_force->computeHydrodynamicForce(u_idx,
                                                   p_idx,
                                                   /*f_idx*/ -1,
@@ -366,64 +1004,124 @@ main(int argc, char* argv[])
                                                   dt,
                                                   navier_stokes_integrator->getVelocityBoundaryConditions(),
                                                   navier_stokes_integrator->getPressureBoundaryConditions());
+            t_compute_hydrodynamic_force->stop();
+
+            // Compare the control volume and Lagrange multiplier forces
+            if (uses_lm_force)
+            {
+                for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+                {
+                    const IBHydrodynamicForceEvaluator::IBHydrodynamicForceObject& cv_force =
+                        hydro_force->getHydrodynamicForceObject(struct_id);
+                    const IBTK::Vector3d dF = lm_force->getForce(struct_id) - cv_force.F_new;
+                    const IBTK::Vector3d dT = lm_force->getTorque(struct_id) - cv_force.T_new;
+                    pout << "Force cross-check of structure " << struct_id << " at time " << new_time
+                         << ": |F_LM - F_CV| = " << dF.norm() << " (|F_CV| = " << cv_force.F_new.norm()
+                         << "), |T_LM - T_CV| = " << dT.norm() << " (|T_CV| = " << cv_force.T_new.norm()
+                         << ")\n";
+                }
+            }
 
             // Print the drag and torque
             hydro_force->postprocessIntegrateData(current_time, new_time);
+        }
 
-            // Update CV plot data
-            hydro_force->updateStructurePlotData(patch_hierarchy, 0);
+        // Update CV plot data and set the torque evaluation axis to point from the newest COM for the next
+        // time step
+        structure_COM = ib_method_ops->getCurrentStructureCOM();
+        for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+        {
+            if (sample_forces) hydro_force->updateStructurePlotData(patch_hierarchy, struct_id);
 
-            // Set the torque origin for the next time step
-            structure_COM = ib_method_ops->getCurrentStructureCOM();
-            for (int d = 0; d < 3; ++d) eel_COM[d] = structure_COM[0][d];
+            IBTK::Vector3d eel_COM;
+            for (int d = 0; d < 3; ++d) eel_COM[d] = structure_COM[struct_id][d];
+            hydro_force->setTorqueOrigin(eel_COM, struct_id);
+        }
 
-            // Set the torque evaluation axis to point from newest COM
-            hydro_force->setTorqueOrigin(eel_COM, 0);
+        // At specified intervals, write visualization and restart files,
+        // print out timer data, and store hierarchy data for post
+        // processing.
+        iteration_num += 1;
+        const bool last_step = !time_integrator->stepsRemaining() || reached_steady_state;
+        if (uses_async_viz && (iteration_num % viz_dump_interval == 0 || last_step))
+        {
+            // Waits for the files of the previous dump, copies the plot data and returns while they are
+            // written.
+            pout << "\nWriting visualization files in the background...\n\n";
+            t_write_plot_data->start();
+            time_integrator->setupPlotData();
+            async_viz_writer->writePlotData(
+                patch_hierarchy, ib_method_ops->getLDataManager(), iteration_num, loop_time);
+            t_write_plot_data->stop();
+        }
+        else if (dump_viz_data && uses_visit && (iteration_num % viz_dump_interval == 0 || last_step))
+        {
+            pout << "\nWriting visualization files...\n\n";
+            t_write_plot_data->start();
+            time_integrator->setupPlotData();
+            visit_data_writer->writePlotData(patch_hierarchy, iteration_num, loop_time);
+            silo_data_writer->writePlotData(iteration_num, loop_time);
+            t_write_plot_data->stop();
+        }
+        if (dump_restart_data && (iteration_num % restart_dump_interval == 0 || last_step))
+        {
+            pout << "\nWriting restart files...\n\n";
+            RestartManager::getManager()->writeRestartFile(restart_dump_dirname, iteration_num);
+        }
+        t_time_step->stop();
 
-            // At specified intervals, write visualization and restart files,
-            // print out timer data, and store hierarchy data for post
-            // processing.
-            iteration_num += 1;
-            const bool last_step = !time_integrator->stepsRemaining();
-            if (dump_viz_data && uses_visit && (iteration_num % viz_dump_interval == 0 || last_step))
-            {
-                pout << "\nWriting visualization files...\n\n";
-                time_integrator->setupPlotData();
-                visit_data_writer->writePlotData(patch_hierarchy, iteration_num, loop_time);
-                silo_data_writer->writePlotData(iteration_num, loop_time);
-            }
-            if (dump_restart_data && (iteration_num % restart_dump_interval == 0 || last_step))
-            {
-                pout << "\nWriting restart files...\n\n";
-                RestartManager::getManager()->writeRestartFile(restart_dump_dirname, iteration_num);
-            }
-            if (dump_timer_data && (iteration_num % timer_dump_interval == 0 || last_step))
-            {
-                pout << "\nWriting timer data...\n\n";
-                TimerManager::getManager()->print(plog);
-            }
-            if (dump_postproc_data && (iteration_num % postproc_data_dump_interval == 0 || last_step))
+        // Record the time spent in each phase during this step.
+        if (phase_writer.isOpen())
+        {
+            phase_row[0] = loop_time;
+            phase_row[1] = iteration_num;
+            for (int k = 0; k < num_phases; ++k)
             {
-                output_data(patch_hierarchy,
-                            navier_stokes_integrator,
-                            ib_method_ops->getLDataManager(),
-                            iteration_num,
-                            loop_time,
-                            postproc_data_dump_dirname);
+                const double wallclock_time = phase_timers[k]->getTotalWallclockTime();
+                phase_row[2 + k] = wallclock_time - phase_wallclock_time[k];
+                phase_wallclock_time[k] = wallclock_time;
             }
+            phase_writer.append(phase_row.data());
         }
+        if (dump_timer_data && (iteration_num % timer_dump_interval == 0 || last_step))
+        {
+            pout << "\nWriting timer data...\n\n";
+            TimerManager::getManager()->print(plog);
+            phase_writer.flush();
+        }
+        if (dump_postproc_data && (iteration_num % postproc_data_dump_interval == 0 || last_step))
+        {
+            output_data(patch_hierarchy,
+                        navier_stokes_integrator,
+                        ib_method_ops->getLDataManager(),
+                        hier_writer.getPointer(),
+                        X_writer.getPointer(),
+                        iteration_num,
+                        loop_time,
+                        postproc_data_dump_dirname);
+        }
+        if (reached_steady_state)
+        {
+            pout << "\nReached a periodic steady state at time " << loop_time << "; stopping the run\n\n";
+            break;
+        }
+    }
 
-        // Cleanup Eulerian boundary condition specification objects (when
-        // necessary).
-        for (unsigned int d = 0; d < NDIM; ++d) delete u_bc_coefs[d];
+    // Make sure the last visualization files are complete.
+    if (uses_async_viz) async_viz_writer->waitForCompletion();
 
-    } // cleanup dynamically allocated objects prior to shutdown
-} // main
+    // Cleanup Eulerian boundary condition specification objects (when
+    // necessary).
+    for (unsigned int d = 0; d < NDIM; ++d) delete u_bc_coefs[d];
+    return;
+} // run_simulation
 
 void
 output_data(Pointer<PatchHierarchy<NDIM> > patch_hierarchy,
             Pointer<INSHierarchyIntegrator> navier_stokes_integrator,
             LDataManager* l_data_manager,
+            HierarchyDataWriter* hier_writer,
+            LagrangianDataWriter* X_writer,
             const int iteration_num,
             const double loop_time,
             const string& data_dump_dirname)
@@ -432,22 +1130,30 @@ output_data(Pointer<PatchHierarchy<NDIM> > patch_hierarchy,
     plog << "simulation time is " << loop_time << endl;
 
     // Write Cartesian data.
-    string file_name = data_dump_dirname + "/" + "hier_data.";
+    string file_name;
     char temp_buf[128];
-    sprintf(temp_buf, "%05d.samrai.%05d", iteration_num, IBTK_MPI::getRank());
-    file_name += temp_buf;
-    Pointer<HDFDatabase> hier_db = new HDFDatabase("hier_db");
-    hier_db->create(file_name);
-    VariableDatabase<NDIM>* var_db = VariableDatabase<NDIM>::getDatabase();
-    ComponentSelector hier_data;
-    hier_data.setFlag(var_db->mapVariableAndContextToIndex(navier_stokes_integrator->getVelocityVariable(),
-                                                           navier_stokes_integrator->getCurrentContext()));
-    hier_data.setFlag(var_db->mapVariableAndContextToIndex(navier_stokes_integrator->getPressureVariable(),
-                                                           navier_stokes_integrator->getCurrentContext()));
-    patch_hierarchy->putToDatabase(hier_db->putDatabase("PatchHierarchy"), hier_data);
-    hier_db->putDouble("loop_time", loop_time);
-    hier_db->putInteger("iteration_num", iteration_num);
-    hier_db->close();
+    if (hier_writer)
+    {
+        hier_writer->writeData(patch_hierarchy, iteration_num, loop_time);
+    }
+    else
+    {
+        file_name = data_dump_dirname + "/" + "hier_data.";
+        sprintf(temp_buf, "%05d.samrai.%05d", iteration_num, IBTK_MPI::getRank());
+        file_name += temp_buf;
+        Pointer<HDFDatabase> hier_db = new HDFDatabase("hier_db");
+        hier_db->create(file_name);
+        VariableDatabase<NDIM>* var_db = VariableDatabase<NDIM>::getDatabase();
+        ComponentSelector hier_data;
+        hier_data.setFlag(var_db->mapVariableAndContextToIndex(navier_stokes_integrator->getVelocityVariable(),
+                                                               navier_stokes_integrator->getCurrentContext()));
+        hier_data.setFlag(var_db->mapVariableAndContextToIndex(navier_stokes_integrator->getPressureVariable(),
+                                                               navier_stokes_integrator->getCurrentContext()));
+        patch_hierarchy->putToDatabase(hier_db->putDatabase("PatchHierarchy"), hier_data);
+        hier_db->putDouble("loop_time", loop_time);
+        hier_db->putInteger("iteration_num", iteration_num);
+        hier_db->close();
+    }
 
     // Write Lagrangian data.
     const int finest_hier_level = patch_hierarchy->getFinestLevelNumber();
@@ -456,13 +1162,145 @@ output_data(Pointer<PatchHierarchy<NDIM> > patch_hierarchy,
     Vec X_lag_vec;
     VecDuplicate(X_petsc_vec, &X_lag_vec);
     l_data_manager->scatterPETScToLagrangian(X_petsc_vec, X_lag_vec, finest_hier_level);
-    file_name = data_dump_dirname + "/" + "X.";
-    sprintf(temp_buf, "%05d", iteration_num);
-    file_name += temp_buf;
-    PetscViewer viewer;
-    PetscViewerASCIIOpen(PETSC_COMM_WORLD, file_name.c_str(), &viewer);
-    VecView(X_lag_vec, viewer);
-    PetscViewerDestroy(&viewer);
+    if (X_writer)
+    {
+        X_writer->writeData(X_lag_vec, iteration_num, loop_time);
+    }
+    else
+    {
+        file_name = data_dump_dirname + "/" + "X.";
+        sprintf(temp_buf, "%05d", iteration_num);
+        file_name += temp_buf;
+        PetscViewer viewer;
+        PetscViewerASCIIOpen(PETSC_COMM_WORLD, file_name.c_str(), &viewer);
+        VecView(X_lag_vec, viewer);
+        PetscViewerDestroy(&viewer);
+    }
     VecDestroy(&X_lag_vec);
     return;
 } // output_data
+
+void
+compute_structure_bounding_boxes(LDataManager* l_data_manager,
+                                 const vector<Pointer<IBEELKinematics> >& eel_kinematics,
+                                 const int ln,
+                                 vector<IBTK::Vector3d>& X_lower,
+                                 vector<IBTK::Vector3d>& X_upper)
+{
+    // Rank-local extents of the points of each structure, followed by one reduction for all structures.
+    const int num_structures = static_cast<int>(eel_kinematics.size());
+    std::vector<double> lower(num_structures * NDIM, std::numeric_limits<double>::max());
+    std::vector<double> upper(num_structures * NDIM, -std::numeric_limits<double>::max());
+    if (l_data_manager->levelContainsLagrangianData(ln))
+    {
+        Pointer<LData> X_data = l_data_manager->getLData("X", ln);
+        const boost::multi_array_ref<double, 2>& X = *X_data->getLocalFormVecArray();
+        const std::vector<LNode*>& local_nodes = l_data_manager->getLMesh(ln)->getLocalNodes();
+        for (std::vector<LNode*>::const_iterator it = local_nodes.begin(); it != local_nodes.end(); ++it)
+        {
+            const int lag_idx = (*it)->getLagrangianIndex();
+            const int local_idx = (*it)->getLocalPETScIndex();
+            for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+            {
+                const std::pair<int, int>& range =
+                    eel_kinematics[struct_id]->getStructureParameters().getLagIdxRange()[0];
+                if (lag_idx < range.first || lag_idx >= range.second) continue;
+                for (int d = 0; d < NDIM; ++d)
+                {
+                    lower[struct_id * NDIM + d] = std::min(lower[struct_id * NDIM + d], X[local_idx][d]);
+                    upper[struct_id * NDIM + d] = std::max(upper[struct_id * NDIM + d], X[local_idx][d]);
+                }
+                break;
+            }
+        }
+        X_data->restoreArrays();
+    }
+    IBTK_MPI::minReduction(lower.data(), num_structures * NDIM);
+    IBTK_MPI::maxReduction(upper.data(), num_structures * NDIM);
+
+    X_lower.resize(num_structures);
+    X_upper.resize(num_structures);
+    for (int struct_id = 0; struct_id < num_structures; ++struct_id)
+    {
+        X_lower[struct_id].setZero();
+        X_upper[struct_id].setZero();
+        for (int d = 0; d < NDIM; ++d)
+        {
+            X_lower[struct_id][d] = lower[struct_id * NDIM + d];
+            X_upper[struct_id][d] = upper[struct_id * NDIM + d];
+        }
+    }
+    return;
+} // compute_structure_bounding_boxes
+
+void
+apply_case_overrides(Pointer<Database> db, Pointer<Database> overrides, const string& path)
+{
+    const Array<string> keys = overrides->getAllKeys();
+    for (int k = 0; k < keys.getSize(); ++k)
+    {
+        const string& key = keys[k];
+        const bool is_new_entry = !db->keyExists(key);
+        if (overrides->isDatabase(key))
+        {
+            if (!db->isDatabase(key))
+            {
+                TBOX_ERROR("apply_case_overrides(): the input file has no database " << path << key << endl);
+            }
+            apply_case_overrides(db->getDatabase(key), overrides->getDatabase(key), path + key + "::");
+        }
+        else if (overrides->isDouble(key) && (is_new_entry || db->isDouble(key)))
+        {
+            db->putDoubleArray(key, overrides->getDoubleArray(key));
+        }
+        else if (overrides->isInteger(key) && (is_new_entry || db->isInteger(key)))
+        {
+            db->putIntegerArray(key, overrides->getIntegerArray(key));
+        }
+        else if (overrides->isBool(key) && (is_new_entry || db->isBool(key)))
+        {
+            db->putBoolArray(key, overrides->getBoolArray(key));
+        }
+        else if (overrides->isString(key) && (is_new_entry || db->isString(key)))
+        {
+            db->putStringArray(key, overrides->getStringArray(key));
+        }
+        else
+        {
+            TBOX_ERROR("apply_case_overrides(): entry " << path << key
+                                                        << " does not have the type of the input file entry" << endl);
+        }
+    }
+    return;
+} // apply_case_overrides
+
+void
+check_case_overrides_read(Pointer<Database> db, Pointer<Database> overrides, const string& path)
+{
+    Pointer<InputDatabase> input_db = db;
+    const Array<string> keys = overrides->getAllKeys();
+    for (int k = 0; k < keys.getSize(); ++k)
+    {
+        const string& key = keys[k];
+        if (overrides->isDatabase(key))
+        {
+            check_case_overrides_read(db->getDatabase(key), overrides->getDatabase(key), path + key + "::");
+        }
+        else if (!input_db.isNull() && !input_db->keyAccessed(key))
+        {
+            TBOX_ERROR("check_case_overrides_read(): entry " << path << key
+                                                             << " of the case was not read by the program" << endl);
+        }
+    }
+    return;
+} // check_case_overrides_read
+
+void
+change_directory(const string& dirname)
+{
+    if (::chdir(dirname.c_str()) != 0)
+    {
+        TBOX_ERROR("change_directory(): cannot change to directory " << dirname << endl);
+    }
+    return;
+} // change_directory
@@ -0,0 +1,406 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2014 - 2022 by the IBAMR developers
+// All rights reserved.
+//
+// This file is part of IBAMR.
+//
+// IBAMR is free software and is distributed under the 3-clause BSD
+// license. The full text of the license can be found in the file
+// COPYRIGHT at the top level directory of IBAMR.
+//
+// ---------------------------------------------------------------------
+
+// Micro-benchmark of the eel kinematics update, independent of IBAMR.
+//
+// The body is laid out for a sweep of mesh widths, starting from the finest mesh width of input2d (2932
+// Lagrangian points) and halving it up to the given refinement, for a straight body, a maneuvering body
+// with a fixed axis, and a maneuvering body that tracks the food location. Each case runs the per-step
+// kinematics phases (maneuvering axis, velocity, shape and its rigid transform) for a number of steps,
+// repeated several times, and reports the time per Lagrangian point and the throughput. With -g the section
+// loops use the generic kernels that test the options at every section instead of the specialized ones.
+// Before timing, the circular arc of the food-tracking backbone is checked against the closed-form arc.
+//
+// Usage: kinematics_benchmark [-r max_refinement] [-n repetitions] [-s steps] [-w workers]
+//                             [-k PARSER|TRAVELING_WAVE|AUTODIFF] [-g]
+
+// Application objects
+#include "AllocationCounter.h"
+#include "CurvatureBackbone.h"
+#include "EelKinematics.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace IBAMR;
+
+namespace
+{
+static const double PII = 3.1415926535897932384626433832795;
+
+// Finest mesh width of input2d: the domain length 8 over 2*64 coarse cells refined twice by 4.
+static const double BASE_MESH_WIDTH = 8.0 / (2 * 64 * 4 * 4);
+
+// Kinematics of input2d.
+static const char* const BODY_SHAPE_EQUATION =
+    "0.125* ( (X_0 + 0.03125)/1.03125 ) * sin( 2*PI*X_0 - (0.785/0.125)*T )";
+static const char* const DEFORMATION_VELOCITY_FUNCTION[] = {
+    "( -0.785* ( (X_0 + 0.03125)/1.03125 )*cos( 2*PI*X_0 - (0.785/0.125)*T ) )*N_0",
+    "( -0.785*  ( (X_0 + 0.03125)/1.03125 )*cos( 2*PI*X_0 - (0.785/0.125)*T ) )*N_1"
+};
+static const char* const MANEUVERING_AXIS_EQUATION = "sqrt(1.3^2 -(X_0 - 0.5)^2) - 1.2";
+static const double FOOD_LOCATION[] = { 1.0, -3.3 };
+static const double TIME_STEP_SIZE = 1.0e-4;
+
+enum ManeuveringCase
+{
+    STRAIGHT,
+    MANEUVERING_AXIS,
+    FOOD_TRACKING,
+    NUM_MANEUVERING_CASES
+};
+static const char* const MANEUVERING_CASE_NAMES[] = { "straight", "maneuvering", "food_tracking" };
+
+enum Phase
+{
+    MANEUVER_AXIS_PHASE,
+    VELOCITY_PHASE,
+    SHAPE_PHASE,
+    TRANSFORM_PHASE,
+    NUM_PHASES
+};
+
+struct BenchmarkOptions
+{
+    int max_refinement = 32;
+    int num_repetitions = 5;
+    int num_steps = 20;
+    int num_workers = 1;
+    EelKinematics::KinematicsType kinematics_type = EelKinematics::PARSER_KINEMATICS;
+    bool use_specialized_kernels = true;
+};
+
+struct Statistics
+{
+    double mean, stddev, min;
+};
+
+Statistics
+compute_statistics(const std::vector<double>& samples)
+{
+    Statistics stats = { 0.0, 0.0, samples.empty() ? 0.0 : samples[0] };
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+        stats.mean += samples[i];
+        stats.min = std::min(stats.min, samples[i]);
+    }
+    stats.mean /= samples.size();
+    for (std::size_t i = 0; i < samples.size(); ++i) stats.stddev += std::pow(samples[i] - stats.mean, 2);
+    if (samples.size() > 1) stats.stddev = std::sqrt(stats.stddev / (samples.size() - 1));
+    return stats;
+} // compute_statistics
+
+void
+configure_kinematics(EelKinematics& kinematics, const BenchmarkOptions& options, const ManeuveringCase maneuvering)
+{
+    // Traveling wave equal to the body shape equation.
+    kinematics.setKinematicsType(options.kinematics_type,
+                                 TravelingWaveKinematics(0.125, 0.03125, 1.03125, 1.0, 2.0 * PII, 0.785 / 0.125));
+
+    std::vector<int> functions(1, EelKinematics::BODY_SHAPE_FUNCTION);
+    std::vector<std::string> expressions(1, BODY_SHAPE_EQUATION);
+    if (options.kinematics_type == EelKinematics::PARSER_KINEMATICS)
+    {
+        for (int d = 0; d < EelKinematics::DIM; ++d)
+        {
+            functions.push_back(EelKinematics::DEFORMATION_VELOCITY_FUNCTION + d);
+            expressions.push_back(DEFORMATION_VELOCITY_FUNCTION[d]);
+        }
+    }
+    if (maneuvering == MANEUVERING_AXIS)
+    {
+        functions.push_back(EelKinematics::MANEUVERING_AXIS_FUNCTION);
+        expressions.push_back(MANEUVERING_AXIS_EQUATION);
+    }
+    for (std::size_t k = 0; k < functions.size(); ++k)
+    {
+        if (!kinematics.setFunction(functions[k], expressions[k]))
+        {
+            throw std::runtime_error("could not compile ``" + expressions[k] +
+                                     " '': " + kinematics.getCompileError(functions[k]));
+        }
+    }
+
+    // A food-tracking body starts straight; its axis is bent into circular arcs at every step.
+    if (maneuvering == FOOD_TRACKING)
+    {
+        kinematics.setFunction(EelKinematics::MANEUVERING_AXIS_FUNCTION, "0.0");
+    }
+    kinematics.setManeuvering(maneuvering != STRAIGHT, false, maneuvering == FOOD_TRACKING);
+    kinematics.setFoodLocation(FOOD_LOCATION);
+    kinematics.setUseSpecializedKernels(options.use_specialized_kernels);
+    return;
+} // configure_kinematics
+
+void
+run_case(const BenchmarkOptions& options, const int refinement, const ManeuveringCase maneuvering)
+{
+    EelKinematics kinematics(options.num_workers);
+    configure_kinematics(kinematics, options, maneuvering);
+    const double mesh_width[EelKinematics::DIM] = { BASE_MESH_WIDTH / refinement, BASE_MESH_WIDTH / refinement };
+    const int num_pts = kinematics.setBodyLayout(mesh_width, 0.0);
+    kinematics.generateShape(0.0);
+    kinematics.transformShape(0.0);
+
+    // Mock rigid-body state of the structure: the body swims along -x and yaws slowly, and its head is the
+    // first Lagrangian point.
+    std::vector<double> center_of_mass(EelKinematics::DIM), tagged_pt_position(EelKinematics::DIM);
+    double time = 0.0;
+    typedef std::chrono::steady_clock Clock;
+    std::vector<std::vector<double> > phase_ns_per_pt(NUM_PHASES);
+    std::vector<double> total_ns_per_pt;
+    unsigned long long num_allocations = 0;
+
+    // The first repetition warms up the caches and is not timed.
+    for (int rep = 0; rep <= options.num_repetitions; ++rep)
+    {
+        std::array<double, NUM_PHASES> phase_ns;
+        phase_ns.fill(0.0);
+        const unsigned long long start_allocation_count = AllocationCounter::getCount();
+        for (int step = 0; step < options.num_steps; ++step)
+        {
+            time += TIME_STEP_SIZE;
+            const double incremented_angle = 0.1 * std::sin(time);
+            const std::vector<std::vector<double> >& shape = kinematics.getShape();
+            center_of_mass[0] = -0.5 * time;
+            center_of_mass[1] = 0.0;
+            for (int d = 0; d < EelKinematics::DIM; ++d) tagged_pt_position[d] = center_of_mass[d] + shape[d][0];
+
+            const Clock::time_point t0 = Clock::now();
+            kinematics.updateManeuverAxis(time, incremented_angle, center_of_mass.data(), tagged_pt_position.data());
+            const Clock::time_point t1 = Clock::now();
+            kinematics.setVelocity(time, incremented_angle);
+            const Clock::time_point t2 = Clock::now();
+            kinematics.generateShape(time);
+            const Clock::time_point t3 = Clock::now();
+            kinematics.transformShape(incremented_angle);
+            const Clock::time_point t4 = Clock::now();
+
+            phase_ns[MANEUVER_AXIS_PHASE] += std::chrono::duration<double, std::nano>(t1 - t0).count();
+            phase_ns[VELOCITY_PHASE] += std::chrono::duration<double, std::nano>(t2 - t1).count();
+            phase_ns[SHAPE_PHASE] += std::chrono::duration<double, std::nano>(t3 - t2).count();
+            phase_ns[TRANSFORM_PHASE] += std::chrono::duration<double, std::nano>(t4 - t3).count();
+        }
+        if (rep == 0) continue;
+
+        num_allocations += AllocationCounter::getCount() - start_allocation_count;
+        double total_ns = 0.0;
+        for (int k = 0; k < NUM_PHASES; ++k)
+        {
+            phase_ns_per_pt[k].push_back(phase_ns[k] / (options.num_steps * static_cast<double>(num_pts)));
+            total_ns += phase_ns[k];
+        }
+        total_ns_per_pt.push_back(total_ns / (options.num_steps * static_cast<double>(num_pts)));
+    }
+
+    // Guard against timing a body whose kinematics broke down.
+    const std::vector<std::vector<double> >& shape = kinematics.getShape();
+    const std::vector<std::vector<double> >& velocity = kinematics.getVelocity();
+    for (int d = 0; d < EelKinematics::DIM; ++d)
+    {
+        for (int i = 0; i < num_pts; ++i)
+        {
+            if (!std::isfinite(shape[d][i]) || !std::isfinite(velocity[d][i]))
+            {
+                throw std::runtime_error(std::string("non-finite kinematics in the ") +
+                                         MANEUVERING_CASE_NAMES[maneuvering] + " case");
+            }
+        }
+    }
+
+    const Statistics total = compute_statistics(total_ns_per_pt);
+    std::cout << std::setw(9) << num_pts << std::setw(15) << MANEUVERING_CASE_NAMES[maneuvering] << std::fixed
+              << std::setprecision(3) << std::setw(11) << total.mean << std::setw(9) << total.stddev << std::setw(9)
+              << total.min;
+    for (int k = 0; k < NUM_PHASES; ++k)
+    {
+        std::cout << std::setw(10) << compute_statistics(phase_ns_per_pt[k]).mean;
+    }
+    std::cout << std::setw(12) << std::setprecision(2) << 1.0e3 / total.mean;
+    if (AllocationCounter::isEnabled())
+    {
+        std::cout << std::setw(12) << static_cast<double>(num_allocations) /
+                                          (options.num_repetitions * options.num_steps);
+    }
+    std::cout << std::endl;
+    return;
+} // run_case
+
+double
+check_circular_arc(const double radius)
+{
+    // Backbone sections of a body of unit length, as laid out by EelKinematics.
+    const int num_sections = static_cast<int>(std::ceil(1.0 / BASE_MESH_WIDTH));
+    std::vector<double> s(num_sections);
+    for (int i = 0; i < num_sections; ++i) s[i] = i * BASE_MESH_WIDTH;
+
+    // The food-tracking arc, integrated from its curvature and centered as in EelKinematics.
+    CurvatureBackbone backbone;
+    backbone.setArcLength(s);
+    const double kappa = -1.0 / radius;
+    backbone.setUniformCurvature(kappa);
+    backbone.setInitialTangentAngle(backbone.getSymmetricArcTangentAngle(kappa));
+    std::vector<double> x(num_sections), y(num_sections), tx(num_sections), ty(num_sections);
+    backbone.integrate(x.data(), y.data(), tx.data(), ty.data());
+
+    // The closed-form arc, (R*sin(theta), R*cos(theta)) for theta symmetric about the vertical.
+    const double arc_angle = (s.back() - s.front()) / radius;
+    std::vector<double> x_arc(num_sections), y_arc(num_sections);
+    double x_cm = 0.0, y_cm = 0.0, x_arc_cm = 0.0, y_arc_cm = 0.0;
+    for (int i = 0; i < num_sections; ++i)
+    {
+        const double theta = -0.5 * arc_angle + s[i] / radius;
+        x_arc[i] = radius * std::sin(theta);
+        y_arc[i] = radius * std::cos(theta);
+        x_cm += x[i];
+        y_cm += y[i];
+        x_arc_cm += x_arc[i];
+        y_arc_cm += y_arc[i];
+    }
+
+    double max_deviation = 0.0;
+    for (int i = 0; i < num_sections; ++i)
+    {
+        max_deviation = std::max(max_deviation,
+                                 std::hypot((x[i] - x_cm / num_sections) - (x_arc[i] - x_arc_cm / num_sections),
+                                            (y[i] - y_cm / num_sections) - (y_arc[i] - y_arc_cm / num_sections)));
+    }
+    return max_deviation;
+} // check_circular_arc
+
+void
+print_usage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [-r max_refinement] [-n repetitions] [-s steps] [-w workers]"
+              << " [-k PARSER|TRAVELING_WAVE|AUTODIFF] [-g]" << std::endl;
+    return;
+} // print_usage
+
+} // namespace
+
+/*******************************************************************************
+ * For each execution mode, this program lays out the eel body for a sweep of  *
+ * mesh widths and maneuvering cases and times the kinematics update.          *
+ *                                                                             *
+ *******************************************************************************/
+int
+main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "-r") && has_value)
+        {
+            options.max_refinement = std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "-n") && has_value)
+        {
+            options.num_repetitions = std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "-s") && has_value)
+        {
+            options.num_steps = std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "-w") && has_value)
+        {
+            options.num_workers = std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "-g"))
+        {
+            options.use_specialized_kernels = false;
+        }
+        else if (!std::strcmp(argv[i], "-k") && has_value)
+        {
+            const std::string type = argv[++i];
+            if (type == "PARSER")
+            {
+                options.kinematics_type = EelKinematics::PARSER_KINEMATICS;
+            }
+            else if (type == "TRAVELING_WAVE")
+            {
+                options.kinematics_type = EelKinematics::TRAVELING_WAVE_KINEMATICS;
+            }
+            else if (type == "AUTODIFF")
+            {
+                options.kinematics_type = EelKinematics::AUTODIFF_KINEMATICS;
+            }
+            else
+            {
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (options.max_refinement < 1 || options.num_repetitions < 1 || options.num_steps < 1 ||
+        options.num_workers < 1)
+    {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+#ifndef _OPENMP
+    if (options.num_workers > 1)
+    {
+        std::cerr << "warning: built without OpenMP; the " << options.num_workers << " workers run serially"
+                  << std::endl;
+    }
+#endif
+
+    static const double ARC_RADII[] = { 0.3, 0.7, 5.0 };
+    for (const double radius : ARC_RADII)
+    {
+        const double deviation = check_circular_arc(radius);
+        if (deviation > 1.0e-10)
+        {
+            std::cerr << "error: the food-tracking backbone of radius " << radius << " deviates by " << deviation
+                      << " from the circular arc" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << "# " << options.num_repetitions << " repetitions of " << options.num_steps << " steps, "
+              << options.num_workers << " worker(s), " << (options.use_specialized_kernels ? "specialized" : "generic")
+              << " kernels; times in ns per Lagrangian point and step\n"
+              << "#   points       case        mean   stddev      min      axis  velocity     shape transform"
+              << "   Mpoints/s" << (AllocationCounter::isEnabled() ? " allocs/step" : "") << std::endl;
+    try
+    {
+        for (int refinement = 1; refinement <= options.max_refinement; refinement *= 2)
+        {
+            for (int maneuvering = 0; maneuvering < NUM_MANEUVERING_CASES; ++maneuvering)
+            {
+                run_case(options, refinement, static_cast<ManeuveringCase>(maneuvering));
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "kinematics_benchmark: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+} // main